@@ -36,9 +36,9 @@ private:
   // Some "shortcuts".
   using Quad = oz::Terra::Quad;
 
-  static constexpr int DIM        = oz::Terra::DIM;
-  static constexpr int VERTS      = oz::Terra::VERTS;
-  static constexpr int QUADS      = oz::Terra::QUADS;
+  static constexpr int DIM        = oz::Terra::MAX_DIM;
+  static constexpr int VERTS      = oz::Terra::MAX_VERTS;
+  static constexpr int QUADS      = oz::Terra::MAX_QUADS;
   static constexpr int TILES      = client::Terra::TILES;
   static constexpr int TILE_QUADS = client::Terra::TILE_QUADS;
 
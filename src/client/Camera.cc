@@ -152,6 +152,8 @@ void Camera::update()
 {
   updateReferences();
 
+  tickPos = p;
+
   if (proxy != nullptr) {
     proxy->update();
   }
@@ -174,6 +176,7 @@ void Camera::reset()
   desiredMag  = 1.0f;
   desiredPos  = Point::ORIGIN;
   oldPos      = Point::ORIGIN;
+  tickPos     = Point::ORIGIN;
 
   relH        = 0.0f;
   relV        = 0.0f;
@@ -227,6 +230,7 @@ void Camera::read(const Json& json)
   desiredRot = rot;
   desiredPos = p;
   oldPos     = p;
+  tickPos    = p;
 
   newState   = State(json["state"].get(STRATEGIC));
 
@@ -244,6 +248,7 @@ void Camera::read(Stream* is)
   desiredMag = mag;
   desiredPos = p;
   oldPos     = p;
+  tickPos    = p;
 
   relH       = is->readFloat();
   relV       = is->readFloat();
@@ -76,6 +76,9 @@ public:
   Point         desiredPos;
   Point         oldPos;
 
+  // Position at the previous tick, for interpolation between ticks.
+  Point         tickPos;
+
   // Camera rotation change (from input).
   float         relH;
   float         relV;
@@ -212,6 +215,15 @@ public:
     p          = p_;
     desiredPos = p_;
     oldPos     = p_;
+    tickPos    = p_;
+  }
+
+  /**
+   * Position interpolated between the last two ticks by `Timer::tickFraction`.
+   */
+  Point interpolatedPos() const
+  {
+    return Math::mix(tickPos, p, timer.tickFraction);
   }
 
   void flash(float intensity);
@@ -59,10 +59,13 @@ static const PPB_MouseInputEvent* ppbMouseInputEvent = nullptr;
 void Client::printUsage()
 {
   Log::printRaw(
-    "Usage: openzone [-v] [-l | -i <mission>] [-t <num>] [-L <lang>] [-p <prefix>]\n"
+    "Usage: openzone [-v] [-l | -i <mission>] [-r <replay>] [-t <num>] [-L <lang>]\n"
+    "                [-p <prefix>]\n"
     "  -l            Skip main menu and load the last autosaved game.\n"
     "  -i <mission>  Skip main menu and start mission <mission>.\n"
     "  -e <layout>   Edit world <layout> file. Create a new one if non-existent.\n"
+    "  -r <replay>   Record the first game session to <replay>. It can be re-simulated\n"
+    "                with 'ozServer -R <replay>'.\n"
     "  -t <num>      Exit after <num> seconds (can be a floating-point number) and\n"
     "                use 42 as the random seed. Useful for benchmarking.\n"
     "  -L <lang>     Use language <lang>. Should match a subdirectory name in\n"
@@ -82,13 +85,15 @@ int Client::main()
 
   SDL_Event event;
 
-  bool            isAlive   = true;
-  bool            isActive  = true;
-  // Time spent on the current frame so far.
-  Duration        timeSpent = Duration::ZERO;
-  Instant<STEADY> timeZero  = Instant<STEADY>::now();
+  bool            isAlive     = true;
+  bool            isActive    = true;
+  // Time spent on the last frame.
+  Duration        timeSpent   = Duration::ZERO;
+  Instant<STEADY> timeZero    = Instant<STEADY>::now();
   // Time at the end of the last frame.
-  Instant<STEADY> timeLast  = timeZero;
+  Instant<STEADY> timeLast    = timeZero;
+  // Real time that has not been simulated yet.
+  Duration        timeBacklog = Duration::ZERO;
 
   initFlags |= INIT_MAIN_LOOP;
 
@@ -250,7 +255,7 @@ int Client::main()
 
     // Waste time when iconified.
     if (!isActive) {
-      Thread::sleepFor(timer.realTickDuration);
+      Thread::sleepFor(Timer::TICK_DURATION);
 
       timeSpent = Instant<STEADY>::now() - timeLast;
       timeLast += timeSpent;
@@ -258,52 +263,71 @@ int Client::main()
       continue;
     }
 
-    input.update();
+    timeSpent    = Instant<STEADY>::now() - timeLast;
+    timeLast    += timeSpent;
+    timeBacklog += timeSpent;
 
-    timer.tick();
+    // Drop time simulation cannot catch up with, otherwise it would run faster than real time.
+    if (timeBacklog > Timer::MAX_CATCHUP_TICKS * Timer::TICK_DURATION) {
+      timer.drop(timeBacklog - Timer::MAX_CATCHUP_TICKS * Timer::TICK_DURATION);
+      timeBacklog = Timer::MAX_CATCHUP_TICKS * Timer::TICK_DURATION;
+    }
 
-    isAlive &= !isBenchmark || timer.duration < benchmarkDuration;
-    isAlive &= stage->update();
+    bool isStageChanged = false;
 
-    if (Stage::nextStage != nullptr) {
-      stage->unload();
+    // Run as many fixed-length ticks as real time requires, only play sounds between them.
+    for (int i = 0; timeBacklog >= Timer::TICK_DURATION; ++i) {
+      if (i != 0) {
+        stage->present(false);
 
-      stage = Stage::nextStage;
-      Stage::nextStage = nullptr;
+        // Input events are only seen by the first tick.
+        input.prepare();
+      }
 
-      input.prepare();
       input.update();
 
-      stage->load();
+      timer.tick();
+      timeBacklog -= Timer::TICK_DURATION;
 
-      timeLast = Instant<STEADY>::now();
-      continue;
-    }
+      isAlive &= !isBenchmark || timer.duration < benchmarkDuration;
+      isAlive &= stage->update();
 
-    timeSpent = Instant<STEADY>::now() - timeLast;
+      if (Stage::nextStage != nullptr) {
+        stage->unload();
 
-    // Skip rendering graphics, only play sounds if there's not enough time left.
-    if (timeSpent >= timer.realTickDuration && timer.frameDuration < 100_ms) {
-      stage->present(false);
-    }
-    else {
-      stage->present(true);
-      timer.frame();
+        stage = Stage::nextStage;
+        Stage::nextStage = nullptr;
 
-      // If there's still some time left, sleep.
-      timeSpent = Instant<STEADY>::now() - timeLast;
+        input.prepare();
+        input.update();
 
-      if (timeSpent < timer.realTickDuration) {
-        stage->wait(timer.realTickDuration - timeSpent);
-        timeSpent = timer.realTickDuration;
+        stage->load();
+
+        timeLast       = Instant<STEADY>::now();
+        timeBacklog    = Duration::ZERO;
+        isStageChanged = true;
+        break;
       }
     }
 
-    if (timeSpent > 100_ms) {
-      timer.drop(timeSpent - timer.realTickDuration);
-      timeLast += timeSpent - timer.realTickDuration;
+    if (isStageChanged) {
+      continue;
+    }
+
+    // Render interpolates positions between the last two ticks.
+    timer.tickFraction = min(timeBacklog.t() / Timer::TICK_TIME, 1.0f);
+
+    stage->present(true);
+    timer.frame();
+
+    // Sleep until the next frame or tick is due, present() does not block without vsync.
+    Duration frameTime = Instant<STEADY>::now() - timeLast;
+    Duration sleepTime = min(Timer::MIN_FRAME_DURATION - frameTime,
+                             Timer::TICK_DURATION - timeBacklog - frameTime);
+
+    if (sleepTime > Duration::ZERO) {
+      stage->wait(sleepTime);
     }
-    timeLast += timer.realTickDuration;
   }
 
   Log::unindent();
@@ -326,6 +350,7 @@ int Client::init(int argc, char** argv)
   String language   = "";
   String mission    = "";
   String layoutFile = "";
+  String replayFile = "";
   bool   doAutoload = false;
 
   // Standalone. Executable is ./bin/<platform>/openzone.
@@ -335,7 +360,7 @@ int Client::init(int argc, char** argv)
 
   optind = 1;
   int opt = 0;
-  while ((opt = getopt(argc, argv, "li:e:t:L:p:vhH?")) != -1) {
+  while ((opt = getopt(argc, argv, "li:e:r:t:L:p:vhH?")) != -1) {
     switch (opt) {
       case 'l': {
         doAutoload = true;
@@ -349,6 +374,10 @@ int Client::init(int argc, char** argv)
         layoutFile = optarg;
         break;
       }
+      case 'r': {
+        replayFile = optarg;
+        break;
+      }
       case 't': {
         const char* end = nullptr;
         benchmarkDuration = String::parseDouble(optarg, &end) * 1_s;
@@ -629,6 +658,8 @@ int Client::init(int argc, char** argv)
 
   Stage::nextStage = nullptr;
 
+  gameStage.replayFile = replayFile;
+
   if (!layoutFile.isEmpty()) {
     editStage.layoutFile = layoutFile;
 
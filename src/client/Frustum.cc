@@ -27,10 +27,10 @@ namespace oz::client
 Span Frustum::getExtremes(const Point& p) const
 {
   return Span{
-    max(int((p.x - radius_ + Orbis::DIM) / Cell::SIZE), 0),
-    max(int((p.y - radius_ + Orbis::DIM) / Cell::SIZE), 0),
-    min(int((p.x + radius_ + Orbis::DIM) / Cell::SIZE), Orbis::CELLS - 1),
-    min(int((p.y + radius_ + Orbis::DIM) / Cell::SIZE), Orbis::CELLS - 1)
+    max(int((p.x - radius_ + orbis.maxs.x) * orbis.cellScale), 0),
+    max(int((p.y - radius_ + orbis.maxs.y) * orbis.cellScale), 0),
+    min(int((p.x + radius_ + orbis.maxs.x) * orbis.cellScale), orbis.nCells - 1),
+    min(int((p.y + radius_ + orbis.maxs.y) * orbis.cellScale), orbis.nCells - 1)
   };
 }
 
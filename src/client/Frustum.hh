@@ -60,8 +60,8 @@ public:
   OZ_ALWAYS_INLINE
   bool isVisible(float x, float y, float radius) const
   {
-    Point mins = Point(x, y, -Orbis::DIM);
-    Point maxs = Point(x, y, +Orbis::DIM);
+    Point mins = Point(x, y, -Orbis::MAX_DIM);
+    Point maxs = Point(x, y, +Orbis::MAX_DIM);
 
     return (mins * left_  > -radius || maxs * left_  > -radius) &&
            (mins * right_ > -radius || maxs * right_ > -radius) &&
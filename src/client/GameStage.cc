@@ -21,6 +21,8 @@
 
 #include <matrix/Synapse.hh>
 #include <matrix/Matrix.hh>
+#include <matrix/LuaMatrix.hh>
+#include <matrix/Replay.hh>
 #include <nirvana/Nirvana.hh>
 #include <client/Context.hh>
 #include <client/Loader.hh>
@@ -36,38 +38,128 @@
 #include <client/ui/LoadingArea.hh>
 #include <client/ui/UI.hh>
 
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace oz::client
 {
 
+namespace
+{
+
+// Append to a file, create it if it doesn't exist.
+bool appendFile(const File& file, const Stream& os)
+{
+#ifdef _WIN32
+  int fd = open(file.c(), O_WRONLY | O_CREAT | O_APPEND | O_BINARY, 0644);
+#else
+  int fd = open(file.c(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+  if (fd < 0) {
+    return false;
+  }
+
+  int64 result = ::write(fd, os.begin(), size_t(os.tell()));
+  close(fd);
+
+  return result == os.tell();
+}
+
+void printLuaMemory(const char* name, const Lua::AllocStats& stats)
+{
+  Log::println("%s  %8.2f MiB used  %8.2f MiB pooled  %8.2f MiB in %lu allocations",
+               name, double(stats.nUsedBytes) / (1024.0 * 1024.0),
+               double(stats.nPooledBytes) / (1024.0 * 1024.0),
+               double(stats.nBytes) / (1024.0 * 1024.0), ulong(stats.nAllocs));
+}
+
+}
+
 void* GameStage::saveMain(void*)
 {
   Log::print("Saving state to %s ...", gameStage.saveFile.c());
 
-  if (!gameStage.saveFile.write(gameStage.saveStream.compress())) {
+  if (!gameStage.saveDelta()) {
     Log::printEnd(" Failed");
     System::bell();
+
+    // Following deltas would refer to a base that has not been saved.
+    gameStage.journalFile = "";
   }
   else {
     Log::printEnd(" OK");
   }
 
   gameStage.saveStream = Stream(0, Endian::LITTLE);
-  gameStage.saveFile = "";
+  gameStage.saveFile   = "";
 
   return nullptr;
 }
 
+void GameStage::writeDelta(Stream* os)
+{
+  int sizePos = os->tell();
+
+  os->writeInt(0);
+
+  matrix.writeDelta(os, isSaveBase);
+  nirvana.write(os);
+
+  camera.write(os);
+
+  luaClient.write(os);
+
+  int endPos = os->tell();
+
+  os->seek(sizePos);
+  os->writeInt(endPos - sizePos - int(sizeof(int)));
+  os->seek(endPos);
+}
+
+bool GameStage::saveDelta() const
+{
+  Stream compressed = saveStream.compress();
+  if (compressed.capacity() == 0) {
+    return false;
+  }
+
+  File deltaFile = saveFile + ".delta";
+
+  if (isSaveBase) {
+    if (!saveFile.write(compressed)) {
+      return false;
+    }
+
+    // Deltas of the previous base are obsolete.
+    if (deltaFile.isRegular()) {
+      deltaFile.remove();
+    }
+    return true;
+  }
+  else {
+    Stream chunk(0, Endian::LITTLE);
+
+    if (nDeltas == 1) {
+      Matrix::writeStateHeader(&chunk);
+      chunk.writeUInt64(journalTick);
+    }
+    chunk.writeInt(compressed.tell());
+    chunk.write(compressed.begin(), compressed.tell());
+
+    return nDeltas == 1 ? deltaFile.write(chunk) : appendFile(deltaFile, chunk);
+  }
+}
+
 void GameStage::read()
 {
   Log::print("Loading state from '%s' ...", stateFile.c());
 
   Stream is(0);
-  if (!stateFile.read(&is)) {
+  if (!Matrix::readState(stateFile, &is)) {
     OZ_ERROR("Reading saved state '%s' failed", stateFile.c());
   }
 
-  is = is.decompress();
-
   Log::printEnd(" OK");
 
   matrix.read(&is);
@@ -93,14 +185,29 @@ void GameStage::write()
 
   OZ_ASSERT(saveStream.capacity() == 0);
 
-  matrix.write(&saveStream);
-  nirvana.write(&saveStream);
+  // Only changes since the last save are appended to the journal, unless it has grown too long or
+  // belongs to a different state file.
+  isSaveBase = stateFile != journalFile || nDeltas == MAX_DELTAS ||
+               (stateFile + ".delta").size() > stateFile.size();
+
+  if (isSaveBase) {
+    journalFile = stateFile;
+    journalTick = timer.nTicks;
+    nDeltas     = 0;
+  }
+  else {
+    ++nDeltas;
+  }
 
-  camera.write(&saveStream);
+  saveFile = stateFile;
 
-  luaClient.write(&saveStream);
+  if (isSaveBase) {
+    Matrix::writeStateHeader(&saveStream);
+  }
 
-  saveFile   = stateFile;
+  // Only changes since the last save are serialised here, at the tick boundary, Lua states and the
+  // world must not change meanwhile. Compression and writing go on while the game runs.
+  writeDelta(&saveStream);
   saveThread = Thread("save", saveMain);
 }
 
@@ -123,13 +230,15 @@ void GameStage::auxRun()
 
     Instant<STEADY> beginInstant = Instant<STEADY>::now();
 
-    network.update();
-
     // update world
+    replay.seedMatrix();
     matrix.update();
 
     matrixDuration += Instant<STEADY>::now() - beginInstant;
 
+    // send world changes while synapse lists are still valid
+    network.update();
+
     mainSemaphore.post();
     auxSemaphore.wait();
 
@@ -148,8 +257,12 @@ void GameStage::auxRun()
     synapse.update();
 
     // update minds
+    replay.seedNirvana();
     nirvana.update();
 
+    replay.nMindUpdates = nirvana.nUpdated;
+    replay.endTick();
+
     nirvanaDuration += Instant<STEADY>::now() - beginInstant;
 
     // we can now manipulate world from the main thread after synapse lists have been cleared
@@ -213,6 +326,14 @@ bool GameStage::update()
 
   luaClient.update();
 
+  replay.recordInput(camera.botObj);
+
+  // A free camera is an observer for minds' levels of detail, the player's bot is one anyway. It is
+  // not recorded, so it is left out while recording for replays to re-simulate the same minds.
+  if (camera.botObj == nullptr && !replay.isRecording) {
+    nirvana.observers.add(camera.p);
+  }
+
   uiDuration += Instant<STEADY>::now() - beginInstant;
 
   auxSemaphore.post();
@@ -250,10 +371,25 @@ void GameStage::present(bool isFull)
   Instant<STEADY> beginInstant   = Instant<STEADY>::now();
   Instant<STEADY> currentInstant;
 
-  sound.play();
-  render.update(Render::EFFECTS_BIT | (isFull ? Render::ORBIS_BIT | Render::UI_BIT : 0));
+  // Frames may be rendered more often than ticks, object events must be processed only once.
+  bool isNewTick = soundTicks != timer.nTicks;
+  int  flags     = (isNewTick ? Render::EFFECTS_BIT : 0) |
+                   (isFull ? Render::ORBIS_BIT | Render::UI_BIT : 0);
+
+  if (isNewTick) {
+    soundTicks = timer.nTicks;
+    sound.play();
+  }
+
+  if (!isFull) {
+    ++droppedFrames;
+  }
 
-  sound.sync();
+  render.update(flags);
+
+  if (isNewTick) {
+    sound.sync();
+  }
 
   currentInstant = Instant<STEADY>::now();
   presentDuration += currentInstant - beginInstant;
@@ -325,6 +461,15 @@ void GameStage::load()
   nirvana.sync();
   synapse.update();
 
+  if (!replayFile.isEmpty()) {
+    Stream state(0, Endian::LITTLE);
+
+    matrix.write(&state);
+    nirvana.write(&state);
+
+    replay.beginRecording(state);
+  }
+
   input.buttons = 0;
   input.currButtons = 0;
 
@@ -333,7 +478,9 @@ void GameStage::load()
 
   ui::ui.questFrame->enable(true);
 
-  startTicks = timer.nTicks;
+  startTicks    = timer.nTicks;
+  soundTicks    = ~uint64(0);
+  droppedFrames = 0;
 
   ui::ui.showLoadingScreen(true);
 
@@ -354,6 +501,10 @@ void GameStage::load()
   loadingDuration = Instant<STEADY>::now() - beginInstant;
   autosaveTicks = 0;
 
+  // The first save writes a new base.
+  journalFile = "";
+  nDeltas     = 0;
+
   Log::unindent();
   Log::println("}");
 }
@@ -409,8 +560,8 @@ void GameStage::unload()
   float    runTime               = timer.realDuration.t();
   float    gameTime              = timer.duration.t();
   float    droppedTime           = (timer.realDuration - timer.duration).t();
-  uint64   nFrameDrops           = nTicks - timer.nFrames;
-  float    frameDropRate         = float(nTicks - timer.nFrames) / float(nTicks);
+  uint64   nFrameDrops           = droppedFrames;
+  float    frameDropRate         = float(droppedFrames) / float(nTicks);
 
   if (stateFile.isEmpty()) {
     stateFile = autosaveFile;
@@ -419,12 +570,30 @@ void GameStage::unload()
     stateFile = "";
   }
 
+  journalFile = "";
+
+  if (replay.isRecording) {
+    Log::print("Writing replay to '%s' ...", replayFile.c());
+    Log::printEnd(replay.endRecording(replayFile) ? " OK" : " Failed");
+
+    // Only the first session is recorded, a reload would overwrite it.
+    replayFile = "";
+  }
+
   profile.save();
 
   ui::ui.questFrame->enable(false);
 
   camera.reset();
 
+  luaClient.flushCallStats("Lua[C] ");
+  luaMatrix.flushCallStats("Lua[M] ");
+  nirvana.flushCallStats();
+
+  Lua::AllocStats clientMemory  = luaClient.allocStats();
+  Lua::AllocStats matrixMemory  = luaMatrix.allocStats();
+  Lua::AllocStats nirvanaMemory = nirvana.allocStats();
+
   MainCall() << []
   {
     context.unload();
@@ -477,6 +646,14 @@ void GameStage::unload()
   Log::unindent();
   Log::println("}");
 
+  Log::println("Lua memory {");
+  Log::indent();
+  printLuaMemory("Lua[C]", clientMemory);
+  printLuaMemory("Lua[M]", matrixMemory);
+  printLuaMemory("Lua[N]", nirvanaMemory);
+  Log::unindent();
+  Log::println("}");
+
   Log::unindent();
   Log::println("}");
 }
@@ -493,8 +670,14 @@ void GameStage::init()
   autosaveFile  = statePath / "autosave.ozState";
   quicksaveFile = statePath / "quicksave.ozState";
 
-  matrix.init();
-  nirvana.init();
+  // Lua states are created in inits below and when loading. Call statistics are added to Profiler
+  // on unload, Client prints them with the rest on exit.
+  Lua::isProfiling = appConfig.include("lua.profile", false).get(false);
+  Lua::gcSlice     = appConfig.include("lua.gcSlice", 0.5f).get(0.5f) * 1_ms;
+
+  matrix.init(appConfig.include("matrix.threads", 1).get(1));
+  nirvana.init(appConfig.include("nirvana.threads", 1).get(1),
+               appConfig.include("nirvana.budget", 4.0f).get(4.0f) * 1_ms);
   loader.init();
   profile.init();
 
@@ -35,8 +35,12 @@ private:
 
   // 2.5 min.
   static constexpr uint AUTOSAVE_INTERVAL = 150 * Timer::TICKS_PER_SEC;
+  // Journal is compacted into a new base after this many deltas.
+  static constexpr int  MAX_DELTAS        = 16;
 
   uint64       startTicks;
+  uint64       soundTicks;
+  uint64       droppedFrames;
   Duration     sleepDuration;
   Duration     loadingDuration;
   Duration     uiDuration;
@@ -50,6 +54,12 @@ private:
   Stream       saveStream;
   File         saveFile;
   Thread       saveThread;
+  bool         isSaveBase;
+
+  // Journal of deltas saved since the last base, see `Matrix::readState()`.
+  File         journalFile;
+  uint64       journalTick;
+  int          nDeltas;
 
   Thread       auxThread;
   Semaphore    mainSemaphore;
@@ -63,12 +73,16 @@ public:
   File         autosaveFile;
   File         quicksaveFile;
   File         stateFile;
+  File         replayFile;
   String       mission;
 
 private:
 
   static void* saveMain(void*);
 
+  void writeDelta(Stream* os);
+  bool saveDelta() const;
+
   void read();
   void write();
 
@@ -24,4 +24,18 @@ namespace oz::client
 
 Imago::~Imago() = default;
 
+Point Imago::interpolatedPos()
+{
+  if (posTicks != timer.nTicks) {
+    prevPos  = posTicks + 1 == timer.nTicks ? tickPos : obj->p;
+    tickPos  = obj->p;
+    posTicks = timer.nTicks;
+
+    if ((tickPos - prevPos).sqN() > MAX_INTERPOLATION_DIST*MAX_INTERPOLATION_DIST) {
+      prevPos = tickPos;
+    }
+  }
+  return Math::mix(prevPos, tickPos, timer.tickFraction);
+}
+
 }
@@ -39,11 +39,20 @@ public:
   static constexpr int UPDATED_BIT  = 0x00000001;
   static constexpr int MD2MODEL_BIT = 0x00000002;
 
+  /// Objects that move farther than this in one tick are not interpolated (teleports, respawns).
+  static constexpr float MAX_INTERPOLATION_DIST = 4.0f;
+
 protected:
 
   const Object*      obj;
   const ObjectClass* clazz;
 
+private:
+
+  Point              prevPos;
+  Point              tickPos;
+  uint64             posTicks = ~uint64(0);
+
 public:
 
   int flags = 0;
@@ -51,9 +60,17 @@ public:
 protected:
 
   explicit Imago(const Object* obj_)
-    : obj(obj_), clazz(obj_->clazz)
+    : obj(obj_), clazz(obj_->clazz), prevPos(obj_->p), tickPos(obj_->p)
   {}
 
+  /**
+   * Object position interpolated between the last two ticks by `Timer::tickFraction`.
+   *
+   * Positions are sampled on the first call after each tick, so an imago that has not been drawn
+   * during the previous tick is drawn at its current position.
+   */
+  Point interpolatedPos();
+
 public:
 
   virtual ~Imago();
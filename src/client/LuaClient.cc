@@ -46,7 +46,7 @@ void LuaClient::staticCall(const char* functionName)
 
   l_getglobal(functionName);
 
-  if (l_pcall(0, 0) != LUA_OK) {
+  if (pcall(functionName, 0, 0) != LUA_OK) {
     Log::println("Lua[C] in %s(): %s", functionName, l_tostring(-1));
     System::bell();
 
@@ -82,7 +82,9 @@ bool LuaClient::exec(const char* code) const
 
 void LuaClient::update()
 {
+  updateMatrixConstants(l_);
   staticCall("onUpdate");
+  stepGarbage();
 }
 
 void LuaClient::create(const char* mission)
@@ -128,6 +130,7 @@ void LuaClient::create(const char* mission)
     json.clear(true);
   }
 
+  updateMatrixConstants(l_);
   loadDir(missionDir);
   staticCall("onCreate");
 
@@ -245,12 +248,16 @@ void LuaClient::init()
 
   IGNORE_FUNC(ozForceUpdate);
 
+  IGNORE_FUNC(ozMathRandom);
+  IGNORE_FUNC(ozMathRandomseed);
+
   /*
    * Orbis
    */
 
   IMPORT_FUNC(ozOrbisGetSize);
   IMPORT_FUNC(ozOrbisGetDim);
+  IMPORT_FUNC(ozOrbisResize);
 
   IMPORT_FUNC(ozOrbisGetGravity);
   IMPORT_FUNC(ozOrbisSetGravity);
@@ -593,6 +600,7 @@ void LuaClient::init()
 
   IGNORE_FUNC(ozSelfOverlaps);
   IGNORE_FUNC(ozSelfBindOverlaps);
+  IGNORE_FUNC(ozSelfObjsVisibleFromEye);
 
   /*
    * Mind
@@ -75,7 +75,7 @@ void MD2Imago::draw(const Imago* parent)
     else {
       h = angleWrap(h + TURN_SMOOTHING_COEF * angleDiff(veh->h, h));
 
-      tf.model = Mat4::translation(obj->p - Point::ORIGIN);
+      tf.model = Mat4::translation(interpolatedPos() - Point::ORIGIN);
       tf.model.rotateZ(h);
 
       model->scheduleMD2Anim(&anim, Model::SCENE_QUEUE);
@@ -90,7 +90,8 @@ void MD2Imago::draw(const Imago* parent)
 
     if (bot->state & Bot::DEAD_BIT) {
       if (parent == nullptr) {
-        Vec3 t = Vec3(obj->p.x, obj->p.y, obj->p.z + clazz->dim.z - clazz->corpseDim.z);
+        Point p = interpolatedPos();
+        Vec3  t = Vec3(p.x, p.y, p.z + clazz->dim.z - clazz->corpseDim.z);
 
         tf.model = Mat4::translation(t);
         tf.model.rotateZ(h);
@@ -104,7 +105,7 @@ void MD2Imago::draw(const Imago* parent)
       h = bot->h;
 
       if (parent == nullptr && weapon != nullptr) {
-        tf.model = Mat4::translation(obj->p - Point::ORIGIN);
+        tf.model = Mat4::translation(interpolatedPos() - Point::ORIGIN);
         tf.model.rotateZ(bot->h);
 
         tf.model.translate(Vec3(0.0f, 0.0f, +bot->camZ));
@@ -122,7 +123,7 @@ void MD2Imago::draw(const Imago* parent)
       if (parent == nullptr) {
         h = angleWrap(h + TURN_SMOOTHING_COEF * angleDiff(bot->h, h));
 
-        tf.model = Mat4::translation(obj->p - Point::ORIGIN);
+        tf.model = Mat4::translation(interpolatedPos() - Point::ORIGIN);
         tf.model.rotateZ(h);
 
         if (bot->state & Bot::CROUCHING_BIT) {
@@ -19,6 +19,8 @@
 
 #include <client/Network.hh>
 
+#include <matrix/Replicator.hh>
+
 //#include <SDL_net.h>
 
 namespace oz::client
@@ -40,6 +42,19 @@ bool Network::connect()
 //  }
 
 //  Log::printEnd(" OK");
+
+  if (isLoopback) {
+    Log::println("Replicating world over loopback");
+
+    replicator.load();
+    packet = Stream(0, Endian::LITTLE);
+
+    nSnapshots     = 0;
+    nBytes         = 0;
+    maxBytes       = 0;
+    encodeDuration = Duration::ZERO;
+    decodeDuration = Duration::ZERO;
+  }
   return true;
 }
 
@@ -47,15 +62,58 @@ void Network::disconnect()
 {
 //  SDLNet_TCP_Close(socket);
 //  socket = nullptr;
+
+  if (isLoopback) {
+    int nTicks = max(nSnapshots, 1);
+
+    Log::println("Loopback replication {");
+    Log::indent();
+    Log::println("%8d  snapshots",             nSnapshots);
+    Log::println("%8.1f  bytes per snapshot",  float(nBytes) / float(nTicks));
+    Log::println("%8d  bytes max",             maxBytes);
+    Log::println("%8.2f  kB/s at tick rate",   float(nBytes) / float(nTicks) *
+                                               float(Timer::TICKS_PER_SEC) / 1000.0f);
+    Log::println("%8.2f  us encoding",         encodeDuration.t() / float(nTicks) * 1.0e6f);
+    Log::println("%8.2f  us decoding",         decodeDuration.t() / float(nTicks) * 1.0e6f);
+    Log::unindent();
+    Log::println("}");
+
+    replicator.unload();
+    packet = Stream();
+  }
 }
 
 void Network::update()
-{}
+{
+  if (!isLoopback) {
+    return;
+  }
+
+  Instant<STEADY> beginInstant = Instant<STEADY>::now();
+
+  packet.rewind();
+  replicator.write(&packet);
+
+  Instant<STEADY> encodedInstant = Instant<STEADY>::now();
+
+  Stream is(packet.begin(), packet.begin() + packet.tell(), Endian::LITTLE);
+  replicator.acknowledge(replicator.read(&is));
+
+  Instant<STEADY> endInstant = Instant<STEADY>::now();
+
+  nSnapshots     += 1;
+  nBytes         += packet.tell();
+  maxBytes        = max(maxBytes, packet.tell());
+  encodeDuration += encodedInstant - beginInstant;
+  decodeDuration += endInstant - encodedInstant;
+}
 
 void Network::init()
 {
 //  SDLNet_Init();
 
+  isLoopback = appConfig.include("net.loopback", false).get(false);
+
 //  host = config.include("net.server", "localhost").get("");
 //  port = uint16(config.include("net.port", 6666).get(0));
 }
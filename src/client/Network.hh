@@ -35,6 +35,16 @@ private:
 //  String host;
 //  uint16 port;
 
+  // Snapshots are encoded, decoded and acknowledged in-process, for measuring replication costs.
+  bool     isLoopback = false;
+  Stream   packet;
+
+  int      nSnapshots;
+  int64    nBytes;
+  int      maxBytes;
+  Duration encodeDuration;
+  Duration decodeDuration;
+
 public:
 
   bool connect();
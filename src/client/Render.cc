@@ -215,14 +215,16 @@ void Render::prepareDraw()
   // drawnStructs
   drawnStructs.clear();
 
-  float minXCentre = float((span.minX - Orbis::CELLS / 2) * Cell::SIZE + Cell::SIZE / 2);
-  float minYCentre = float((span.minY - Orbis::CELLS / 2) * Cell::SIZE + Cell::SIZE / 2);
+  float cellSize   = float(orbis.cellSize);
+  float cellRadius = (cellSize / 2.0f + Object::MAX_DIM * WIDE_CULL_FACTOR) * 1.41f;
+  float minXCentre = orbis.mins.x + float(span.minX) * cellSize + cellSize / 2.0f;
+  float minYCentre = orbis.mins.y + float(span.minY) * cellSize + cellSize / 2.0f;
 
   float x = minXCentre;
-  for (int i = span.minX; i <= span.maxX; ++i, x = x + Cell::SIZE) {
+  for (int i = span.minX; i <= span.maxX; ++i, x = x + cellSize) {
     float y = minYCentre;
-    for (int j = span.minY; j <= span.maxY; ++j, y = y + Cell::SIZE) {
-      if (frustum.isVisible(x, y, CELL_RADIUS)) {
+    for (int j = span.minY; j <= span.maxY; ++j, y = y + cellSize) {
+      if (frustum.isVisible(x, y, cellRadius)) {
         scheduleCell(i, j);
       }
     }
@@ -256,7 +258,7 @@ void Render::drawGeometry()
   // camera transformation
   tf.projection();
   tf.camera = camera.rotTMat;
-  tf.camera.translate(Point::ORIGIN - camera.p);
+  tf.camera.translate(Point::ORIGIN - camera.interpolatedPos());
 
   shader.setAmbientLight(Caelum::GLOBAL_AMBIENT_COLOUR + caelum.ambientColour);
   shader.setCaelumLight(caelum.lightDir, caelum.diffuseColour);
@@ -284,7 +286,7 @@ void Render::drawGeometry()
 
     caelum.draw();
 
-    tf.camera.translate(Point::ORIGIN - camera.p);
+    tf.camera.translate(Point::ORIGIN - camera.interpolatedPos());
     tf.applyCamera();
   }
   else {
@@ -50,8 +50,6 @@ private:
   static constexpr float WIDE_CULL_FACTOR       = 6.0f;
   static constexpr float OBJECT_VISIBILITY_COEF = 0.004f;
   static constexpr float FRAG_VISIBILITY_RANGE2 = 150.0f*150.0f;
-  static constexpr float CELL_RADIUS            = (Cell::SIZE / 2 +
-                                                   Object::MAX_DIM * WIDE_CULL_FACTOR) * 1.41f;
   static constexpr float EFFECTS_DISTANCE       = 192.0f;
 
   static constexpr float NIGHT_FOG_COEFF        = 2.0f;
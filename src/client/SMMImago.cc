@@ -46,7 +46,7 @@ void SMMImago::draw(const Imago*)
     return;
   }
 
-  tf.model = Mat4::translation(obj->p - Point::ORIGIN);
+  tf.model = Mat4::translation(interpolatedPos() - Point::ORIGIN);
   tf.model.rotateZ(float(obj->flags & Object::HEADING_MASK) * Math::TAU / 4.0f);
 
   model->schedule(0, Model::SCENE_QUEUE);
@@ -74,7 +74,7 @@ void Transform::projection()
 void Transform::applyCamera()
 {
   glUniformMatrix4fv(uniform.projCamera, 1, GL_FALSE, proj * camera);
-  glUniform3fv(uniform.cameraPos, 1, client::camera.p);
+  glUniform3fv(uniform.cameraPos, 1, client::camera.interpolatedPos());
 }
 
 void Transform::apply() const
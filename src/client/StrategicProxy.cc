@@ -148,9 +148,9 @@ void StrategicProxy::update()
       desiredPos.z -= speed;
     }
 
-    desiredPos.x = clamp<float>(desiredPos.x, -Orbis::DIM, +Orbis::DIM);
-    desiredPos.y = clamp<float>(desiredPos.y, -Orbis::DIM, +Orbis::DIM);
-    desiredPos.z = clamp<float>(desiredPos.z, -Orbis::DIM, +Orbis::DIM);
+    desiredPos.x = clamp<float>(desiredPos.x, orbis.mins.x, orbis.maxs.x);
+    desiredPos.y = clamp<float>(desiredPos.y, orbis.mins.y, orbis.maxs.y);
+    desiredPos.z = clamp<float>(desiredPos.z, orbis.mins.z, orbis.maxs.z);
   }
   else {
     // RTS camera mode
@@ -179,8 +179,8 @@ void StrategicProxy::update()
       ui::ui.strategicArea->mouseW = 0.0f;
     }
 
-    desiredPos.x = clamp<float>(desiredPos.x, -Orbis::DIM, +Orbis::DIM);
-    desiredPos.y = clamp<float>(desiredPos.y, -Orbis::DIM, +Orbis::DIM);
+    desiredPos.x = clamp<float>(desiredPos.x, orbis.mins.x, orbis.maxs.x);
+    desiredPos.y = clamp<float>(desiredPos.y, orbis.mins.y, orbis.maxs.y);
     desiredPos.z = max(0.0f, orbis.terra.getHeight(desiredPos.x, desiredPos.y)) + height;
   }
 
@@ -36,10 +36,12 @@ void Terra::draw()
   // we draw column-major (triangle strips along y axis) for better cache performance
   glFrontFace(GL_CW);
 
-  span.minX = max(int((camera.p.x - frustum.radius() + oz::Terra::DIM) / TILE_SIZE), 0);
-  span.minY = max(int((camera.p.y - frustum.radius() + oz::Terra::DIM) / TILE_SIZE), 0);
-  span.maxX = min(int((camera.p.x + frustum.radius() + oz::Terra::DIM) / TILE_SIZE), TILES - 1);
-  span.maxY = min(int((camera.p.y + frustum.radius() + oz::Terra::DIM) / TILE_SIZE), TILES - 1);
+  float dim = float(oz::Terra::MAX_DIM);
+
+  span.minX = max(int((camera.p.x - frustum.radius() + dim) / TILE_SIZE), tiles.minX);
+  span.minY = max(int((camera.p.y - frustum.radius() + dim) / TILE_SIZE), tiles.minY);
+  span.maxX = min(int((camera.p.x + frustum.radius() + dim) / TILE_SIZE), tiles.maxX);
+  span.maxY = min(int((camera.p.y + frustum.radius() + dim) / TILE_SIZE), tiles.maxY);
 
   shader.program(landShaderId);
 
@@ -176,8 +178,22 @@ void Terra::load()
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, iboSize, is.readSkip(iboSize), GL_STATIC_DRAW);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+  // Matrix only keeps the part of terrain under the world, vertices past its edges are clamped.
+  int offset = orbis.terra.offset;
+  int nQuads = orbis.terra.nQuads;
+
+  tiles.minX = offset / TILE_QUADS;
+  tiles.minY = offset / TILE_QUADS;
+  tiles.maxX = (offset + nQuads - 1) / TILE_QUADS;
+  tiles.maxY = (offset + nQuads - 1) / TILE_QUADS;
+
   for (int i = 0; i < TILES; ++i) {
     for (int j = 0; j < TILES; ++j) {
+      if (i < tiles.minX || i > tiles.maxX || j < tiles.minY || j > tiles.maxY) {
+        is.readSkip(TILE_VERTICES * 3);
+        continue;
+      }
+
       Vertex* vertices = new Vertex[TILE_VERTICES];
 
       for (int k = 0; k <= TILE_QUADS; ++k) {
@@ -185,14 +201,16 @@ void Terra::load()
           int x = i * TILE_QUADS + k;
           int y = j * TILE_QUADS + l;
 
+          const oz::Terra::Quad& quad = orbis.terra.quads[clamp(x - offset, 0, nQuads)]
+                                                         [clamp(y - offset, 0, nQuads)];
           Vertex& vertex = vertices[k * (TILE_QUADS + 1) + l];
 
-          vertex.pos[0]      = orbis.terra.quads[x][y].vertex.x;
-          vertex.pos[1]      = orbis.terra.quads[x][y].vertex.y;
-          vertex.pos[2]      = orbis.terra.quads[x][y].vertex.z;
+          vertex.pos[0]      = quad.vertex.x;
+          vertex.pos[1]      = quad.vertex.y;
+          vertex.pos[2]      = quad.vertex.z;
 
           vertex.texCoord[0] = int16(x);
-          vertex.texCoord[1] = int16(oz::Terra::VERTS - y);
+          vertex.texCoord[1] = int16(oz::Terra::MAX_VERTS - y);
 
           vertex.normal[0]   = is.readByte();
           vertex.normal[1]   = is.readByte();
@@ -33,7 +33,7 @@ class Terra
 public:
 
   static constexpr int   TILE_QUADS    = 32;
-  static constexpr int   TILES         = oz::Terra::QUADS / TILE_QUADS;
+  static constexpr int   TILES         = oz::Terra::MAX_QUADS / TILE_QUADS;
 
 private:
 
@@ -56,6 +56,7 @@ private:
 
   float                  waveBias;
 
+  Span                   tiles;       ///< Tiles that cover the world, others are not drawn.
   Span                   span;
   SBitset<TILES * TILES> liquidTiles;
 
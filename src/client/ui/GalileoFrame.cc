@@ -75,8 +75,8 @@ void GalileoFrame::onUpdate()
 bool GalileoFrame::onMouseEvent()
 {
   if (input.buttons) {
-    clickX = -Orbis::DIM + float(mouse.x - x) / float(width ) * 2.0f * Orbis::DIM;
-    clickY = -Orbis::DIM + float(mouse.y - y) / float(height) * 2.0f * Orbis::DIM;
+    clickX = -oz::Terra::MAX_DIM + float(mouse.x - x) / float(width ) * 2.0f * oz::Terra::MAX_DIM;
+    clickY = -oz::Terra::MAX_DIM + float(mouse.y - y) / float(height) * 2.0f * oz::Terra::MAX_DIM;
   }
   return true;
 }
@@ -112,8 +112,8 @@ void GalileoFrame::onDraw()
 
     glBindTexture(GL_TEXTURE_2D, style.images.marker);
 
-    float mapX = oX + (Orbis::DIM + quest.place.x) / (2.0f*Orbis::DIM) * fWidth;
-    float mapY = oY + (Orbis::DIM + quest.place.y) / (2.0f*Orbis::DIM) * fHeight;
+    float mapX = oX + (oz::Terra::MAX_DIM + quest.place.x) / (2.0f*oz::Terra::MAX_DIM) * fWidth;
+    float mapY = oY + (oz::Terra::MAX_DIM + quest.place.y) / (2.0f*oz::Terra::MAX_DIM) * fHeight;
 
     tf.model = Mat4::translation(Vec3(mapX, mapY, 0.0f));
     tf.model.scale(Vec3(16.0f, 16.0f, 0.0f));
@@ -125,8 +125,8 @@ void GalileoFrame::onDraw()
 
   glBindTexture(GL_TEXTURE_2D, style.images.arrow);
 
-  float mapX = oX + (Orbis::DIM + pX) / (2.0f*Orbis::DIM) * fWidth;
-  float mapY = oY + (Orbis::DIM + pY) / (2.0f*Orbis::DIM) * fHeight;
+  float mapX = oX + (oz::Terra::MAX_DIM + pX) / (2.0f*oz::Terra::MAX_DIM) * fWidth;
+  float mapY = oY + (oz::Terra::MAX_DIM + pY) / (2.0f*oz::Terra::MAX_DIM) * fHeight;
 
   tf.model = Mat4::translation(Vec3(mapX, mapY, 0.0f));
   tf.model.rotateZ(h);
@@ -36,6 +36,8 @@ void Timer::reset()
 
   realTickDuration = Duration::ZERO;
   realDuration     = Duration::ZERO;
+
+  tickFraction     = 0.0f;
 }
 
 void Timer::tick()
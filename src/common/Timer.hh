@@ -46,6 +46,12 @@ public:
   /// Length of one tick in seconds.
   static constexpr float TICK_TIME = 1.0f / float(TICKS_PER_SEC);
 
+  /// Maximum number of ticks run in a row to catch up with real time, the rest is dropped.
+  static constexpr int MAX_CATCHUP_TICKS = 5;
+
+  /// Shortest time between rendered frames, main loop sleeps the rest unless a tick is due first.
+  static constexpr Duration MIN_FRAME_DURATION = TICK_DURATION / int64(2);
+
 private:
 
   int nTicksInSecond_ = 0; ///< Number of ticks elapsed for the current second.
@@ -63,6 +69,8 @@ public:
   Duration realTickDuration;  ///< Wait time for a tick.
   Duration realDuration;      ///< Run time (game time plus dropped time).
 
+  float    tickFraction  = 0.0f; ///< Real time elapsed since the last tick, in [0, 1) ticks.
+
 public:
 
   /**
@@ -75,6 +75,182 @@ struct Span
   int maxY; ///< Maximum Y.
 };
 
+/**
+ * Square 2D array with heap storage, indexed as `grid[x][y]`.
+ */
+template <typename Elem>
+class Grid
+{
+private:
+
+  Elem* data_ = nullptr; ///< Elements, row by row.
+  int   size_ = 0;       ///< Number of elements on each axis.
+
+public:
+
+  OZ_NO_COPY(Grid)
+
+  /**
+   * Create an empty grid.
+   */
+  Grid() = default;
+
+  /**
+   * Destructor.
+   */
+  ~Grid()
+  {
+    delete[] data_;
+  }
+
+  /**
+   * Pointer to the first element of the `x`-th row.
+   */
+  OZ_ALWAYS_INLINE
+  const Elem* operator[](int x) const
+  {
+    OZ_ASSERT(uint(x) < uint(size_));
+
+    return data_ + x * size_;
+  }
+
+  /**
+   * Pointer to the first element of the `x`-th row.
+   */
+  OZ_ALWAYS_INLINE
+  Elem* operator[](int x)
+  {
+    OZ_ASSERT(uint(x) < uint(size_));
+
+    return data_ + x * size_;
+  }
+
+  /**
+   * Constant pointer to the first element.
+   */
+  OZ_ALWAYS_INLINE
+  const Elem* begin() const noexcept
+  {
+    return data_;
+  }
+
+  /**
+   * Pointer to the first element.
+   */
+  OZ_ALWAYS_INLINE
+  Elem* begin() noexcept
+  {
+    return data_;
+  }
+
+  /**
+   * Constant pointer past the last element.
+   */
+  OZ_ALWAYS_INLINE
+  const Elem* end() const noexcept
+  {
+    return data_ + size_ * size_;
+  }
+
+  /**
+   * Pointer past the last element.
+   */
+  OZ_ALWAYS_INLINE
+  Elem* end() noexcept
+  {
+    return data_ + size_ * size_;
+  }
+
+  /**
+   * Number of elements on each axis.
+   */
+  OZ_ALWAYS_INLINE
+  int size() const noexcept
+  {
+    return size_;
+  }
+
+  /**
+   * Reallocate to `size` x `size` default-constructed elements if the size differs.
+   */
+  void resize(int size)
+  {
+    if (size != size_) {
+      delete[] data_;
+
+      data_ = size == 0 ? nullptr : new Elem[size * size];
+      size_ = size;
+    }
+  }
+};
+
+/**
+ * Pseudo-random generator with its own state (xorshift64*).
+ *
+ * Unlike `Math::rand()`, which shares the C library state with all threads, the sequence only
+ * depends on the seed and on draws from this instance.
+ */
+class Random
+{
+private:
+
+  uint64 state_ = 0x9e3779b97f4a7c15;
+
+public:
+
+  /**
+   * Reset state for a given seed, nearby seeds give unrelated sequences.
+   */
+  void seed(int n)
+  {
+    uint64 z = uint64(uint(n)) + 0x9e3779b97f4a7c15;
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    z = z ^ (z >> 31);
+
+    state_ = z == 0 ? 0x9e3779b97f4a7c15 : z;
+  }
+
+  /**
+   * Next 64 random bits.
+   */
+  OZ_ALWAYS_INLINE
+  uint64 next()
+  {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 0x2545f4914f6cdd1d;
+  }
+
+  /**
+   * Random integer from `[min, max)`, the same range as `Math::rand()`.
+   */
+  OZ_ALWAYS_INLINE
+  int rand(int min, int max)
+  {
+    return min + int(next() >> 33) % (max - min);
+  }
+
+  /**
+   * Random float from `[min, max)`.
+   */
+  OZ_ALWAYS_INLINE
+  float rand(float min, float max)
+  {
+    return min + float(next() >> 40) / float(1 << 24) * (max - min);
+  }
+
+  /**
+   * Random number with the same distribution as `Math::normalRand()`.
+   */
+  float normalRand(float mean = 0.0f, float deviation = 1.0f)
+  {
+    return mean + deviation * Math::tan(rand(-1.0f, +1.0f) * Math::TAU / 8.0f);
+  }
+};
+
 /**
  * Wrap angle to the interval \f$ [0, \tau) \f$.
  */
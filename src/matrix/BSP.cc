@@ -25,8 +25,70 @@
 namespace oz
 {
 
+void BSP::flatten()
+{
+  nSideQuads = 0;
+
+  for (int i = 0; i < nBrushes; ++i) {
+    nSideQuads += (brushes[i].nSides + 3) / 4;
+  }
+
+  size_t size = 0;
+
+  size += Math::alignUp(nNodes     * sizeof(flatNodes[0]));
+  size += Math::alignUp(nSideQuads * sizeof(sideQuads[0]));
+  size += Math::alignUp(nBrushes   * sizeof(brushQuads[0]));
+
+  flatData = new(std::align_val_t(16)) char[size];
+
+  char* p = flatData;
+
+  flatNodes = new(p) FlatNode[nNodes];
+  for (int i = 0; i < nNodes; ++i) {
+    flatNodes[i].plane = planes[nodes[i].plane];
+    flatNodes[i].front = nodes[i].front;
+    flatNodes[i].back  = nodes[i].back;
+  }
+  p = Math::alignUp(p + nNodes * sizeof(flatNodes[0]));
+
+  sideQuads = new(p) SideQuad[nSideQuads];
+  p = Math::alignUp(p + nSideQuads * sizeof(sideQuads[0]));
+
+  brushQuads = new(p) int[nBrushes];
+
+  for (int i = 0, quad = 0; i < nBrushes; ++i) {
+    const Brush& brush  = brushes[i];
+    int          nQuads = (brush.nSides + 3) / 4;
+
+    brushQuads[i] = quad;
+
+    for (int j = 0; j < nQuads * 4; ++j) {
+      SideQuad& sideQuad = sideQuads[quad + j / 4];
+      int       lane     = j % 4;
+
+      if (j < brush.nSides) {
+        const Plane& plane = planes[brushSides[brush.firstSide + j]];
+
+        sideQuad.nx[lane] = plane.n.x;
+        sideQuad.ny[lane] = plane.n.y;
+        sideQuad.nz[lane] = plane.n.z;
+        sideQuad.d[lane]  = plane.d;
+      }
+      else {
+        sideQuad.nx[lane] = 0.0f;
+        sideQuad.ny[lane] = 0.0f;
+        sideQuad.nz[lane] = 0.0f;
+        sideQuad.d[lane]  = Math::INF;
+      }
+    }
+
+    quad += nQuads;
+  }
+}
+
 BSP::~BSP()
 {
+  operator delete[](flatData, (std::align_val_t(16)));
   operator delete[](data, (std::align_val_t(16)));
 }
 
@@ -175,6 +237,8 @@ BSP::BSP(const char* name_, int id_)
   }
 
   OZ_ASSERT(is.available() == 0);
+
+  flatten();
 }
 
 }
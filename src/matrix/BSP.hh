@@ -131,6 +131,31 @@ public:
     int flags;     ///< %Material and medium bits (look `matrix::Material` and `matrix::Medium`).
   };
 
+  /**
+   * %BSP node with inline separating plane, built at load time for collision queries.
+   */
+  struct FlatNode
+  {
+    Plane plane; ///< Separating plane.
+
+    int   front; ///< Index of node on the positive side of the separating plane.
+    int   back;  ///< Index of node on the negative side of the separating plane.
+  };
+
+  /**
+   * Four brush side planes in structure-of-arrays layout, built at load time.
+   *
+   * Each brush's sides occupy `(nSides + 3) / 4` consecutive quads. Unused lanes are filled with
+   * planes that never separate anything (zero normal, infinite distance).
+   */
+  struct alignas(16) SideQuad
+  {
+    float nx[4];
+    float ny[4];
+    float nz[4];
+    float d[4];
+  };
+
   struct BoundObject
   {
     const ObjectClass* clazz;
@@ -138,7 +163,8 @@ public:
     Heading            heading;
   };
 
-  char*           data = nullptr;
+  char*           data     = nullptr;
+  char*           flatData = nullptr;
 
   Plane*          planes;
   Node*           nodes;
@@ -149,6 +175,10 @@ public:
   int*            brushSides;
   BoundObject*    boundObjects;
 
+  FlatNode*       flatNodes;
+  SideQuad*       sideQuads;
+  int*            brushQuads;    ///< Index of the first side quad for each brush.
+
   int             nPlanes;
   int             nNodes;
   int             nLeaves;
@@ -157,6 +187,7 @@ public:
   int             nBrushes;
   int             nBrushSides;
   int             nBoundObjects;
+  int             nSideQuads;
 
   String          name;          ///< Name.
   String          title;         ///< Title.
@@ -173,8 +204,33 @@ public:
 
   int             id;            ///< Used for indexing BSPs in Context.
 
+private:
+
+  void flatten();
+
 public:
 
+  /**
+   * First side quad of a brush.
+   */
+  OZ_ALWAYS_INLINE
+  const SideQuad* brushSideQuads(const Brush* brush) const
+  {
+    return &sideQuads[brushQuads[brush - brushes]];
+  }
+
+  /**
+   * `i`-th side plane from a brush's side quads.
+   */
+  OZ_ALWAYS_INLINE
+  static Plane sidePlane(const SideQuad* quads, int i)
+  {
+    const SideQuad& quad = quads[i / 4];
+    int             j    = i % 4;
+
+    return Plane(quad.nx[j], quad.ny[j], quad.nz[j], quad.d[j]);
+  }
+
   BSP() = default;
   ~BSP();
 
@@ -19,6 +19,7 @@
 
 #include <matrix/Bot.hh>
 
+#include <matrix/Liber.hh>
 #include <matrix/LuaMatrix.hh>
 #include <matrix/Physics.hh>
 #include <matrix/Synapse.hh>
@@ -666,6 +667,7 @@ void Bot::onUpdate()
               p += possibleMove;
               collider.translate(this, Vec3(0.0f, 0.0f, -raise));
               p = raisedPos;
+              orbis.resort(this);
 
               if (collider.hit.ratio != 1.0f && collider.hit.normal.z >= Physics::FLOOR_NORMAL_Z) {
                 momentum.x *= 1.0f - Physics::LADDER_FRICTION;
@@ -801,7 +803,7 @@ stepSucceeded:
           meleeTime = clazz->meleeInterval;
 
           addEvent(EVENT_MELEE, 1.0f);
-          luaMatrix.objectCall(clazz->onMelee, this, this);
+          luaMatrix.objectCall(clazz->onMeleeIndex, this, this);
         }
       }
       else if (!(state & CROUCHING_BIT)) {
@@ -894,6 +896,7 @@ stepSucceeded:
           momDiff.z          -= physics.gravity * Timer::TICK_TIME;
 
           cargoObj->flags    &= ~DISABLED_BIT;
+          cargoObj->wake();
           cargoObj->momentum += momDiff;
         }
       }
@@ -1097,8 +1100,9 @@ Bot::Bot(const BotClass* clazz_, int index_, const Point& p_, Heading heading)
 
   camZ       = clazz_->camZ;
 
-  name       = luaMatrix.nameGenCall(clazz_->nameFunc);
+  name       = luaMatrix.nameGenCall(clazz_->nameFuncIndex);
   mind       = clazz_->mind;
+  mindIndex  = liber.luaFunctionIndex(mind);
 }
 
 Bot::Bot(const BotClass* clazz_, int index_, const Json& json)
@@ -1126,6 +1130,7 @@ Bot::Bot(const BotClass* clazz_, int index_, const Json& json)
 
   name       = json["name"].get("");
   mind       = json["mind"].get("");
+  mindIndex  = liber.luaFunctionIndex(mind);
 
   for (const Json& stateJson : json["state"].arrayCRange()) {
     OZ_STATE_READ(DEAD_BIT,         "dead"        )
@@ -1168,6 +1173,7 @@ Bot::Bot(const BotClass* clazz_, Stream* is)
 
   name       = is->readString();
   mind       = is->readString();
+  mindIndex  = liber.luaFunctionIndex(mind);
 
   if (state & CROUCHING_BIT) {
     dim = clazz_->crouchDim;
@@ -1225,10 +1231,44 @@ void Bot::write(Stream* os) const
   os->writeString(mind);
 }
 
-void Bot::readUpdate(Stream*)
-{}
+void Bot::readUpdate(Stream* is)
+{
+  const BotClass* clazz = static_cast<const BotClass*>(this->clazz);
+
+  Dynamic::readUpdate(is);
+
+  h          = unpackAngle(is->readUInt16());
+  v          = unpackAngle(is->readUInt16());
+  oldActions = actions;
+  actions    = is->readInt();
+  instrument = is->readInt();
+  container  = is->readInt();
+
+  oldState   = state;
+  state      = is->readInt();
+  stamina    = unpackRatio(is->readUByte()) * clazz->stamina;
+
+  cargo      = is->readInt16();
+  weapon     = is->readInt16();
+}
+
+void Bot::writeUpdate(Stream* os) const
+{
+  const BotClass* clazz = static_cast<const BotClass*>(this->clazz);
+
+  Dynamic::writeUpdate(os);
+
+  os->writeUInt16(packAngle(h));
+  os->writeUInt16(packAngle(v));
+  os->writeInt(actions);
+  os->writeInt(instrument);
+  os->writeInt(container);
 
-void Bot::writeUpdate(Stream*) const
-{}
+  os->writeInt(state);
+  os->writeUByte(packRatio(stamina / clazz->stamina));
+
+  os->writeInt16(int16(cargo));
+  os->writeInt16(int16(weapon));
+}
 
 }
@@ -182,6 +182,7 @@ public:
 
   String name;
   String mind;
+  int    mindIndex; // in `Liber::luaFunctions`, -1 if not referenced by a class
 
 public:
 
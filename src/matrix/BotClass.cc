@@ -143,14 +143,18 @@ void BotClass::init(const Json& config, const char* name_)
   weaponItem        = config["weaponItem"].get(-1);
   meleeInterval     = config["meleeInterval"].get(0.5f);
   onMelee           = config["onMelee"].get("");
+  onMeleeIndex      = liber.addLuaFunction(onMelee);
 
   if (!String::isEmpty(onMelee)) {
     flags |= Object::LUA_BIT;
   }
 
   nameFunc          = config["nameFunc"].get("");
+  nameFuncIndex     = liber.addLuaFunction(nameFunc);
   mind              = config["mind"].get("");
 
+  liber.addLuaFunction(mind);
+
   bobRotation       = Math::rad(config["bobRotation"].get(0.35f));
   bobAmplitude      = config["bobAmplitude"].get(0.07f);
   bobSwimAmplitude  = config["bobSwimAmplitude"].get(0.07f);
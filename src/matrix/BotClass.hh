@@ -88,8 +88,10 @@ public:
   int    weaponItem;
   float  meleeInterval;
   String onMelee;
+  int    onMeleeIndex;
 
   String nameFunc;
+  int    nameFuncIndex;
   String mind;
   int    mindAutomaton;
 
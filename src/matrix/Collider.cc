@@ -65,10 +65,35 @@ bool Collider::overlapsAABBObj(const Object* sObj) const
 
 bool Collider::overlapsAABBBrush(const BSP::Brush* brush) const
 {
+  const BSP::SideQuad* quads  = bsp->brushSideQuads(brush);
+  int                  nQuads = (brush->nSides + 3) / 4;
+
+#ifdef OZ_SIMD
+
+  float4 px      = vFill(startPos.x);
+  float4 py      = vFill(startPos.y);
+  float4 pz      = vFill(startPos.z);
+  float4 dimX    = vFill(localDim.x);
+  float4 dimY    = vFill(localDim.y);
+  float4 dimZ    = vFill(localDim.z);
+  uint4  outside = vFill(0u);
+
+  for (int i = 0; i < nQuads; ++i) {
+    const float4* quad = reinterpret_cast<const float4*>(&quads[i]);
+
+    float4 offset = dimX * vAbs(quad[0]) + dimY * vAbs(quad[1]) + dimZ * vAbs(quad[2]);
+    float4 dist   = px * quad[0] + py * quad[1] + pz * quad[2] - quad[3] - offset;
+
+    outside |= uint4(dist > vFill(EPSILON));
+  }
+  return (outside[0] | outside[1] | outside[2] | outside[3]) == 0;
+
+#else
+
   bool result = true;
 
-  for (int i = 0; i < brush->nSides; ++i) {
-    const Plane& plane = bsp->planes[bsp->brushSides[brush->firstSide + i]];
+  for (int i = 0; i < nQuads * 4; ++i) {
+    Plane plane = BSP::sidePlane(quads, i);
 
     float offset = localDim * abs(plane.n);
     float dist   = startPos * plane - offset;
@@ -76,6 +101,8 @@ bool Collider::overlapsAABBBrush(const BSP::Brush* brush) const
     result &= dist <= EPSILON;
   }
   return result;
+
+#endif
 }
 
 bool Collider::overlapsAABBNode(int nodeIndex)
@@ -94,8 +121,8 @@ bool Collider::overlapsAABBNode(int nodeIndex)
     return false;
   }
   else {
-    const BSP::Node& node  = bsp->nodes[nodeIndex];
-    const Plane&     plane = bsp->planes[node.plane];
+    const BSP::FlatNode& node  = bsp->flatNodes[nodeIndex];
+    const Plane&         plane = node.plane;
 
     float offset = localDim * abs(plane.n) + 2.0f * EPSILON;
     float dist   = startPos * plane;
@@ -177,7 +204,7 @@ bool Collider::overlapsAABBOrbis()
         }
       }
 
-      for (const Object* sObj = cell.objects.first(); sObj != nullptr; sObj = sObj->next[0]) {
+      for (const Object* sObj : cell.objectsNear(trace.mins.x, trace.maxs.x)) {
         if (sObj != exclObj && (sObj->flags & mask) && overlapsAABBObj(sObj)) {
           return true;
         }
@@ -197,7 +224,7 @@ bool Collider::overlapsEntityObjects()
     for (int y = span.minY; y <= span.maxY; ++y) {
       const Cell& cell = orbis.cells[x][y];
 
-      for (const Object* sObj = cell.objects.first(); sObj != nullptr; sObj = sObj->next[0]) {
+      for (const Object* sObj : cell.objectsNear(trace.mins.x, trace.maxs.x)) {
         if (trace.overlaps(*sObj)) {
           startPos = str->toStructCS(sObj->p) - entity->offset;
           localDim = str->swapDimCS(sObj->dim + Vec3(margin, margin, margin));
@@ -379,12 +406,14 @@ void Collider::trimAABBObj(const Object* sObj)
 
 void Collider::trimAABBBrush(const BSP::Brush* brush)
 {
+  const BSP::SideQuad* quads = bsp->brushSideQuads(brush);
+
   float minRatio   = -1.0f;
   float maxRatio   = +1.0f;
   Vec3  lastNormal = Vec3::ZERO;
 
   for (int i = 0; i < brush->nSides; ++i) {
-    const Plane& plane = bsp->planes[bsp->brushSides[brush->firstSide + i]];
+    Plane plane = BSP::sidePlane(quads, i);
 
     float offset    = localDim * abs(plane.n);
     float startDist = startPos * plane - offset;
@@ -420,10 +449,12 @@ void Collider::trimAABBBrush(const BSP::Brush* brush)
 
 void Collider::trimAABBLiquid(const BSP::Brush* brush)
 {
+  const BSP::SideQuad* quads = bsp->brushSideQuads(brush);
+
   float depth = Math::INF;
 
   for (int i = 0; i < brush->nSides; ++i) {
-    const Plane& plane = bsp->planes[bsp->brushSides[brush->firstSide + i]];
+    Plane plane = BSP::sidePlane(quads, i);
 
     float offset = localDim * abs(plane.n);
     float dist   = startPos * plane - offset;
@@ -453,8 +484,10 @@ void Collider::trimAABBLiquid(const BSP::Brush* brush)
 
 void Collider::trimAABBArea(const BSP::Brush* brush)
 {
+  const BSP::SideQuad* quads = bsp->brushSideQuads(brush);
+
   for (int i = 0; i < brush->nSides; ++i) {
-    const Plane& plane = bsp->planes[bsp->brushSides[brush->firstSide + i]];
+    Plane plane = BSP::sidePlane(quads, i);
 
     float offset = localDim * abs(plane.n);
     float dist   = startPos * plane - offset;
@@ -491,8 +524,8 @@ void Collider::trimAABBNode(int nodeIndex)
     }
   }
   else {
-    const BSP::Node& node  = bsp->nodes[nodeIndex];
-    const Plane&     plane = bsp->planes[node.plane];
+    const BSP::FlatNode& node  = bsp->flatNodes[nodeIndex];
+    const Plane&         plane = node.plane;
 
     float offset    = localDim * abs(plane.n) + 2.0f * EPSILON;
     float startDist = startPos * plane;
@@ -666,7 +699,7 @@ void Collider::trimAABBOrbis()
       startPos = originalStartPos;
       endPos   = originalEndPos;
 
-      for (const Object* sObj = cell.objects.first(); sObj != nullptr; sObj = sObj->next[0]) {
+      for (const Object* sObj : cell.objectsNear(trace.mins.x, trace.maxs.x)) {
         if (sObj != exclObj && (sObj->flags & mask) && trace.overlaps(*sObj)) {
           trimAABBObj(sObj);
         }
@@ -684,6 +717,54 @@ void Collider::trimAABBOrbis()
   OZ_ASSERT(hit.depth >= 0.0f);
 }
 
+void Collider::trimBatchRay(const Point& origin, const Point& target)
+{
+  hit = Hit();
+
+  move  = target - origin;
+  trace = Bounds(origin, 2.0f * EPSILON).expand(move);
+
+  startPos = origin;
+  endPos   = target;
+
+  if (!orbis.includes(trace)) {
+    trimAABBVoid();
+  }
+
+  for (const Struct* batchStr : batchStructs) {
+    if (!trace.overlaps(*batchStr)) {
+      continue;
+    }
+
+    str = batchStr;
+    visitedBrushes.clear();
+
+    startPos = str->toStructCS(origin);
+    endPos   = str->toStructCS(target);
+    localDim = str->swapDimCS(aabb.dim);
+    bsp      = str->bsp;
+    entity   = nullptr;
+
+    trimAABBNode(0);
+    trimAABBEntities();
+  }
+
+  startPos = origin;
+  endPos   = target;
+
+  for (const Object* sObj : batchObjects) {
+    if (trace.overlaps(*sObj)) {
+      trimAABBObj(sObj);
+    }
+  }
+
+  trimAABBTerra();
+
+  OZ_ASSERT(0.0f <= hit.ratio && hit.ratio <= 1.0f);
+  OZ_ASSERT(((hit.material & Material::OBJECT_BIT) != 0) == (hit.obj != nullptr));
+  OZ_ASSERT(hit.depth >= 0.0f);
+}
+
 void Collider::trimEntityObjects()
 {
   hit = Hit();
@@ -692,7 +773,7 @@ void Collider::trimEntityObjects()
     for (int y = span.minY; y <= span.maxY; ++y) {
       const Cell& cell = orbis.cells[x][y];
 
-      for (const Object* sObj = cell.objects.first(); sObj != nullptr; sObj = sObj->next[0]) {
+      for (const Object* sObj : cell.objectsNear(trace.mins.x, trace.maxs.x)) {
         if ((sObj->flags & mask) && trace.overlaps(*sObj)) {
           startPos = str->toStructCS(sObj->p) - entity->offset;
           endPos   = startPos - move;
@@ -752,7 +833,7 @@ void Collider::getOrbisOverlaps(List<Struct*>* structs, List<Object*>* objects)
       }
 
       if (objects != nullptr) {
-        for (const Object* sObj = cell.objects.first(); sObj != nullptr; sObj = sObj->next[0]) {
+        for (const Object* sObj : cell.objectsNear(trace.mins.x, trace.maxs.x)) {
           if ((sObj->flags & mask) && trace.overlaps(*sObj)) {
             objects->add(const_cast<Object*>(sObj));
           }
@@ -770,7 +851,7 @@ void Collider::getEntityOverlaps(List<Object*>* objects)
     for (int y = span.minY; y <= span.maxY; ++y) {
       const Cell& cell = orbis.cells[x][y];
 
-      for (const Object* sObj = cell.objects.first(); sObj != nullptr; sObj = sObj->next[0]) {
+      for (const Object* sObj : cell.objectsNear(trace.mins.x, trace.maxs.x)) {
         if ((sObj->flags & mask) && trace.overlaps(*sObj)) {
           startPos = str->toStructCS(sObj->p) - entity->offset;
           localDim = str->swapDimCS(sObj->dim + Vec3(margin, margin, margin));
@@ -815,6 +896,45 @@ bool Collider::overlaps(const AABB& aabb_, const Object* exclObj_)
   return overlapsAABBOrbis();
 }
 
+bool Collider::mayOverlap(const Bounds& bounds) const
+{
+  if (!orbis.includes(bounds, -EPSILON)) {
+    return true;
+  }
+
+  Span terraSpan = orbis.terra.getInters(bounds.mins.x, bounds.mins.y,
+                                         bounds.maxs.x, bounds.maxs.y);
+
+  for (int x = terraSpan.minX; x <= terraSpan.maxX + 1; ++x) {
+    for (int y = terraSpan.minY; y <= terraSpan.maxY + 1; ++y) {
+      if (orbis.terra.quads[x][y].vertex.z >= bounds.mins.z) {
+        return true;
+      }
+    }
+  }
+
+  Span cellSpan = orbis.getInters(bounds, Object::MAX_DIM);
+
+  for (int x = cellSpan.minX; x <= cellSpan.maxX; ++x) {
+    for (int y = cellSpan.minY; y <= cellSpan.maxY; ++y) {
+      const Cell& cell = orbis.cells[x][y];
+
+      for (int strIndex : cell.structs) {
+        if (bounds.overlaps(*orbis.str(strIndex))) {
+          return true;
+        }
+      }
+
+      for (const Object* sObj : cell.objectsNear(bounds.mins.x, bounds.maxs.x)) {
+        if ((sObj->flags & mask) && bounds.overlaps(*sObj)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
 bool Collider::overlaps(const Object* obj_)
 {
   aabb    = *obj_;
@@ -897,6 +1017,52 @@ void Collider::translate(const Entity* entity_, const Vec3& localMove)
   trimEntityObjects();
 }
 
+void Collider::translate(const Point& origin, const Point* targets, int nTargets, Hit* hits,
+                         const Object* exclObj_)
+{
+  aabb    = AABB(origin, Vec3::ZERO);
+  exclObj = exclObj_;
+  flags   = Object::CYLINDER_BIT;
+
+  Bounds batchTrace = Bounds(origin, 2.0f * EPSILON);
+
+  for (int i = 0; i < nTargets; ++i) {
+    batchTrace |= Bounds(targets[i], 2.0f * EPSILON);
+  }
+
+  span = orbis.getInters(batchTrace, Object::MAX_DIM);
+
+  batchStructs.clear();
+  batchObjects.clear();
+  visitedStructs.clear();
+
+  for (int x = span.minX; x <= span.maxX; ++x) {
+    for (int y = span.minY; y <= span.maxY; ++y) {
+      const Cell& cell = orbis.cells[x][y];
+
+      for (int strIndex : cell.structs) {
+        const Struct* cellStr = orbis.str(strIndex);
+
+        if (!visitedStructs.get(strIndex) && batchTrace.overlaps(*cellStr)) {
+          visitedStructs.set(strIndex);
+          batchStructs.add(cellStr);
+        }
+      }
+
+      for (const Object* sObj : cell.objectsNear(batchTrace.mins.x, batchTrace.maxs.x)) {
+        if (sObj != exclObj && (sObj->flags & mask) && batchTrace.overlaps(*sObj)) {
+          batchObjects.add(sObj);
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < nTargets; ++i) {
+    trimBatchRay(origin, targets[i]);
+    hits[i] = hit;
+  }
+}
+
 void Collider::getOverlaps(const AABB& aabb_, List<Struct*>* structs, List<Object*>* objects,
                            float margin_)
 {
@@ -921,6 +1087,6 @@ void Collider::getOverlaps(const Entity* entity_, List<Object*>* objects, float
   getEntityOverlaps(objects);
 }
 
-Collider collider;
+thread_local Collider collider;
 
 }
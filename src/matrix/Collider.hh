@@ -99,6 +99,9 @@ private:
   int                         flags;
   float                       margin;
 
+  List<const Struct*>         batchStructs;
+  List<const Object*>         batchObjects;
+
 public:
 
   int                         mask = Object::SOLID_BIT; /// Filter for `Object::flags`.
@@ -133,6 +136,8 @@ private:
 
   void trimEntityObjects();
 
+  void trimBatchRay(const Point& origin, const Point& target);
+
   void getOrbisOverlaps(List<Struct*>* structs, List<Object*>* objects);
   void getEntityOverlaps(List<Object*>* objects);
 
@@ -143,11 +148,29 @@ public:
   bool overlaps(const Object* obj_);
   bool overlaps(const Entity* entity_, float margin_ = 0.0f);
 
+  /**
+   * Conservative test whether terrain, a structure or an object may be inside given bounds.
+   *
+   * Only bounding boxes and terrain vertices are tested, so it's much cheaper than an exact test
+   * and a false result means `translate()` within the bounds won't hit anything.
+   */
+  bool mayOverlap(const Bounds& bounds) const;
+
   void translate(const Point& point, const Vec3& move_, const Object* exclObj_ = nullptr);
   void translate(const AABB& aabb_, const Vec3& move_, const Object* exclObj_ = nullptr);
   void translate(const Dynamic* obj_, const Vec3& move_);
   void translate(const Entity* entity_, const Vec3& localMove);
 
+  /**
+   * Sweep a point from `origin` to each of `targets`, writing `hit` for each ray into `hits`.
+   *
+   * Cells and structures around all rays are gathered in a single pass, each ray is then trimmed
+   * only against the gathered structures and objects its own trace overlaps. Results are the same
+   * as for individual `translate()` calls but much cheaper when many rays share an origin.
+   */
+  void translate(const Point& origin, const Point* targets, int nTargets, Hit* hits,
+                 const Object* exclObj_ = nullptr);
+
   // fill given vectors with objects and structures overlapping with the AABB
   // if either vector is nullptr the respective test is not performed
   void getOverlaps(const AABB& aabb_, List<Struct*>* structs, List<Object*>* objects, float margin_);
@@ -155,6 +178,12 @@ public:
 
 };
 
-extern Collider collider;
+/**
+ * Collider for the calling thread.
+ *
+ * Query state is kept per thread, so collision queries may run on several threads at once as long
+ * as nobody modifies the world meanwhile.
+ */
+extern thread_local Collider collider;
 
 }
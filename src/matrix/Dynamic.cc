@@ -31,7 +31,7 @@ Pool<Dynamic> Dynamic::pool(4096);
 void Dynamic::onDestroy()
 {
   if (!clazz->onDestroy.isEmpty()) {
-    luaMatrix.objectCall(clazz->onDestroy, this);
+    luaMatrix.objectCall(clazz->onDestroyIndex, this);
   }
 
   for (int i : items) {
@@ -133,10 +133,25 @@ void Dynamic::write(Stream* os) const
   os->writeFloat(depth);
 }
 
-void Dynamic::readUpdate(Stream*)
-{}
+void Dynamic::readUpdate(Stream* is)
+{
+  Object::readUpdate(is);
+
+  velocity.x = unpackVelocity(is->readInt16());
+  velocity.y = unpackVelocity(is->readInt16());
+  velocity.z = unpackVelocity(is->readInt16());
+  momentum   = velocity;
+  parent     = is->readInt16();
+}
 
-void Dynamic::writeUpdate(Stream*) const
-{}
+void Dynamic::writeUpdate(Stream* os) const
+{
+  Object::writeUpdate(os);
+
+  os->writeInt16(packVelocity(velocity.x));
+  os->writeInt16(packVelocity(velocity.y));
+  os->writeInt16(packVelocity(velocity.z));
+  os->writeInt16(int16(parent));
+}
 
 }
@@ -46,6 +46,8 @@ public:
   float mass;     ///< Mass.
   float lift;     ///< Lift / weight (water only, for lava Physics::LAVA_LIFT is used).
 
+  int   nextSleeper = -1; ///< Next object in the sleeping island's ring, -1 if awake.
+
 protected:
 
   void onDestroy() override;
@@ -45,7 +45,7 @@ HashMap<String, BSP>                      bspMap;
 HashMap<String, ObjectClass*>             objClassMap;
 HashMap<String, FragPool>                 fragPoolMap;
 
-HashMap<String, int>                      mindIndices;
+HashMap<String, int>                      luaFunctionIndices;
 
 }
 
@@ -161,18 +161,27 @@ int Liber::musicTrackIndex(const char* name) const
   return *value;
 }
 
-int Liber::mindIndex(const char* name) const
+int Liber::luaFunctionIndex(const char* name) const
 {
   if (String::isEmpty(name)) {
     return -1;
   }
 
-  const int* value = mindIndices.find(name);
+  const int* value = luaFunctionIndices.find(name);
+  return value == nullptr ? -1 : *value;
+}
 
-  if (value == nullptr) {
-    OZ_ERROR("Invalid mind requested '%s'", name);
+int Liber::addLuaFunction(const char* name)
+{
+  int index = luaFunctionIndex(name);
+
+  if (index == -1 && !String::isEmpty(name)) {
+    index = luaFunctions.size();
+
+    luaFunctions.add(name);
+    luaFunctionIndices.add(name, index);
   }
-  return *value;
+  return index;
 }
 
 const FragPool* Liber::fragPool(const char* name) const
@@ -203,6 +212,11 @@ const ObjectClass* Liber::objClass(const char* name) const
   return *value;
 }
 
+bool Liber::hasObjClass(const char* name) const
+{
+  return objClassMap.contains(name);
+}
+
 const BSP* Liber::bsp(const char* name) const
 {
   if (String::isEmpty(name)) {
@@ -784,8 +798,10 @@ void Liber::destroy()
   musicTrackIndices.clear();
   musicTrackIndices.trim();
 
-  mindIndices.clear();
-  mindIndices.trim();
+  luaFunctions.clear();
+  luaFunctions.trim();
+  luaFunctionIndices.clear();
+  luaFunctionIndices.trim();
 
   devices.clear();
   devices.trim();
@@ -51,6 +51,9 @@ public:
   List<Resource>           parts;
   List<Resource>           models;
 
+  // Names of Lua functions referenced by classes, Lua states bind them by index.
+  List<String>             luaFunctions;
+
   List<const FragPool*>    fragPools;
   List<const ObjectClass*> objClasses;
   List<const BSP*>         bsps;
@@ -71,10 +74,23 @@ public:
   int partIndex(const char* name) const;
   int modelIndex(const char* name) const;
 
-  int mindIndex(const char* name) const;
+  /**
+   * Index of a Lua function in `luaFunctions`, -1 if the name is empty or not referenced by any
+   * class.
+   */
+  int luaFunctionIndex(const char* name) const;
+
+  /**
+   * Add Lua function to `luaFunctions` if not there yet and return its index, -1 if empty.
+   *
+   * Should only be called by classes while being initialised.
+   */
+  int addLuaFunction(const char* name);
 
   const FragPool* fragPool(const char* name) const;
   const ObjectClass* objClass(const char* name) const;
+  // Unlike `objClass()`, doesn't fail on unknown names, for checking untrusted input.
+  bool hasObjClass(const char* name) const;
   const BSP* bsp(const char* name) const;
 
   int deviceIndex(const char* name) const;
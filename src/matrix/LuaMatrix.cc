@@ -32,7 +32,7 @@ LuaMatrix& lua = luaMatrix;
 
 }
 
-String LuaMatrix::nameGenCall(const char* functionName)
+String LuaMatrix::nameGenCall(int function)
 {
   lua_State* l = l_;
 
@@ -48,10 +48,12 @@ String LuaMatrix::nameGenCall(const char* functionName)
 
   String name = "";
 
-  if (!String::isEmpty(functionName)) {
-    l_getglobal(functionName);
+  if (function != -1) {
+    const char* functionName = liber.luaFunctions[function];
 
-    if (l_pcall(0, 1) != LUA_OK) {
+    pushFunction(function, functionName);
+
+    if (pcall(functionName, 0, 1) != LUA_OK) {
       Log::println("Lua[M] in %s(): %s", functionName, l_tostring(-1));
       System::bell();
     }
@@ -65,7 +67,7 @@ String LuaMatrix::nameGenCall(const char* functionName)
   return name;
 }
 
-bool LuaMatrix::objectCall(const char* functionName, Object* self, Bot* user)
+bool LuaMatrix::objectCall(int function, Object* self, Bot* user)
 {
   lua_State* l = l_;
 
@@ -79,12 +81,13 @@ bool LuaMatrix::objectCall(const char* functionName, Object* self, Bot* user)
 
   OZ_ASSERT(l_gettop() == 1 && self != nullptr);
 
-  bool success = true;
+  bool        success      = true;
+  const char* functionName = function == -1 ? "" : liber.luaFunctions[function].c();
 
-  l_getglobal(functionName);
+  pushFunction(function, functionName);
   l_rawgeti(1, self->index);
 
-  if (l_pcall(1, 1) != LUA_OK) {
+  if (pcall(functionName, 1, 1) != LUA_OK) {
     Log::println("Lua[M] in %s(self = %d, user = %d): %s",
                  functionName, self->index, user == nullptr ? -1 : user->index, l_tostring(-1));
     System::bell();
@@ -99,6 +102,12 @@ bool LuaMatrix::objectCall(const char* functionName, Object* self, Bot* user)
   return success;
 }
 
+void LuaMatrix::update(int seed)
+{
+  updateMatrixConstants(l_);
+  ms.random.seed(seed);
+}
+
 void LuaMatrix::registerObject(int index)
 {
   lua_State* l = l_;
@@ -180,12 +189,20 @@ void LuaMatrix::init()
   IMPORT_FUNC(ozError);
   IMPORT_FUNC(ozPrintln);
 
+  /*
+   * Math
+   */
+
+  lua["math"]["random"]     = ozMathRandom;
+  lua["math"]["randomseed"] = ozMathRandomseed;
+
   /*
    * Orbis
    */
 
   IMPORT_FUNC(ozOrbisGetSize);
   IMPORT_FUNC(ozOrbisGetDim);
+  IMPORT_FUNC(ozOrbisResize);
 
   IMPORT_FUNC(ozOrbisGetGravity);
   IMPORT_FUNC(ozOrbisSetGravity);
@@ -477,6 +494,8 @@ void LuaMatrix::init()
   loadDir("@lua/common");
   loadDir("@lua/matrix");
 
+  bindFunctions(liber.luaFunctions);
+
   OZ_ASSERT(l_gettop() == 1);
 
   Log::printEnd(" OK");
@@ -40,8 +40,15 @@ public:
 
 public:
 
-  String nameGenCall(const char* functionName);
-  bool objectCall(const char* functionName, Object* self, Bot* user = nullptr);
+  // Functions are given by their indices in `Liber::luaFunctions`.
+  String nameGenCall(int function);
+  bool objectCall(int function, Object* self, Bot* user = nullptr);
+
+  /**
+   * Refresh world constants and seed the generator behind `math.random()`, called by Matrix
+   * before each update.
+   */
+  void update(int seed);
 
   void registerObject(int index);
   void unregisterObject(int index);
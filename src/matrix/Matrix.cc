@@ -20,13 +20,449 @@
 #include <matrix/Matrix.hh>
 
 #include <matrix/LuaMatrix.hh>
-#include <matrix/Physics.hh>
 #include <matrix/Synapse.hh>
 #include <matrix/Vehicle.hh>
 
 namespace oz
 {
 
+namespace
+{
+
+// Remove references to objects that no longer exist from the object's inventory, true iff any
+// were removed. The caller must touch the object then.
+bool pruneItems(Object* obj)
+{
+  bool isPruned = false;
+
+  for (int j = 0; j < obj->items.size();) {
+    if (orbis.obj(obj->items[j]) == nullptr) {
+      obj->items.erase(j);
+      isPruned = true;
+    }
+    else {
+      ++j;
+    }
+  }
+  return isPruned;
+}
+
+// Still object that nothing but a sleeping island or a floor is supposed to disturb.
+bool isResting(const Dynamic* dyn)
+{
+  int flags = dyn->flags;
+
+  return (flags & (Object::DYNAMIC_BIT | Object::DISABLED_BIT)) ==
+           (Object::DYNAMIC_BIT | Object::DISABLED_BIT) &&
+         !(flags & (Object::UPDATE_FUNC_BIT | Object::ENABLE_BIT | Object::DESTROYED_BIT)) &&
+         // Objects lying on structure entities must follow them.
+         !((flags & Object::ON_FLOOR_BIT) && dyn->lower != -1) &&
+         dyn->cell != nullptr && dyn->life != 0.0f && dyn->events.isEmpty() &&
+         dyn->items.isEmpty();
+}
+
+// Name and state of a structure or an object in a delta.
+struct Record
+{
+  const char* data = nullptr;
+  int         size = 0;
+};
+
+// Latest parts of state from a sequence of deltas, pointing into delta buffers.
+struct MergedState
+{
+  const char*  timer     = nullptr;
+  const char*  head      = nullptr;
+  int          headSize  = 0;
+  const char*  tail      = nullptr;
+  int          tailSize  = 0;
+  List<Record> structs   = List<Record>(Orbis::MAX_STRUCTS);
+  List<Record> objects   = List<Record>(Orbis::MAX_OBJECTS);
+};
+
+bool readStateHeader(Stream* is)
+{
+  return is->order() == Endian::LITTLE && is->available() >= int(2 * sizeof(int)) &&
+         is->readUInt() == Matrix::STATE_MAGIC && is->readInt() == Matrix::STATE_VERSION;
+}
+
+// Merge deltas from a stream into the state, false if any is cut short or malformed.
+bool mergeDeltas(Stream* is, MergedState* state)
+{
+  while (is->available() != 0) {
+    if (is->available() < int(sizeof(int))) {
+      return false;
+    }
+
+    int deltaSize = is->readInt();
+    if (deltaSize < 0 || is->available() < deltaSize) {
+      return false;
+    }
+
+    const char* deltaBegin = is->readSkip(deltaSize);
+    Stream      delta(deltaBegin, deltaBegin + deltaSize, is->order());
+
+    if (delta.available() < int(sizeof(uint64) + sizeof(int64) + sizeof(int))) {
+      return false;
+    }
+
+    state->timer    = delta.readSkip(int(sizeof(uint64) + sizeof(int64)));
+    state->headSize = delta.readInt();
+
+    if (state->headSize < 0 || delta.available() < state->headSize) {
+      return false;
+    }
+    state->head = delta.readSkip(state->headSize);
+
+    for (List<Record>* records : {&state->structs, &state->objects}) {
+      while (true) {
+        if (delta.available() < int(sizeof(int))) {
+          return false;
+        }
+
+        int index = delta.readInt();
+        if (index == -1) {
+          break;
+        }
+        if (uint(index) >= uint(records->size()) || delta.available() < int(sizeof(int))) {
+          return false;
+        }
+
+        int size = delta.readInt();
+        if (size < 0 || delta.available() < size) {
+          return false;
+        }
+        (*records)[index] = Record{size == 0 ? nullptr : delta.readSkip(size), size};
+      }
+    }
+
+    // Number of fragments at least.
+    if (delta.available() < int(sizeof(int))) {
+      return false;
+    }
+
+    state->tailSize = delta.available();
+    state->tail     = delta.readSkip(state->tailSize);
+  }
+  return true;
+}
+
+}
+
+void* Matrix::workerMain(void* data)
+{
+  matrix.workerRun(static_cast<Worker*>(data));
+  return nullptr;
+}
+
+void Matrix::workerRun(Worker* worker)
+{
+  worker->semaphore.wait();
+
+  while (areWorkersAlive.load<RELAXED>()) {
+    updateIslands(worker);
+
+    workerSemaphore.post();
+    worker->semaphore.wait();
+  }
+}
+
+int Matrix::findClaim(int node)
+{
+  while (claimParents[node] != node) {
+    claimParents[node] = claimParents[claimParents[node]];
+    node = claimParents[node];
+  }
+  return node;
+}
+
+void Matrix::claimCells(int node, const Bounds& bounds)
+{
+  // The same margin as in Collider, so claimed cells cover everything collision tests may touch.
+  Span span = orbis.getInters(bounds, Object::MAX_DIM);
+
+  for (int x = span.minX; x <= span.maxX; ++x) {
+    for (int y = span.minY; y <= span.maxY; ++y) {
+      int& claim = cellClaims[x][y];
+
+      if (claim == -1) {
+        claim = node;
+        claimedCells.add(x * cellClaims.size() + y);
+      }
+      else {
+        int root     = findClaim(claim);
+        int nodeRoot = findClaim(node);
+
+        // The lowest node is kept as the root, so islands are ordered by their first objects.
+        if (root < nodeRoot) {
+          claimParents[nodeRoot] = root;
+        }
+        else if (nodeRoot < root) {
+          claimParents[root] = nodeRoot;
+        }
+      }
+    }
+  }
+}
+
+void Matrix::buildIslands()
+{
+  claimObjects.clear();
+  claimParents.clear();
+  claimSerial.clear();
+  islands.clear();
+  islandObjects.clear();
+  islandMembers.clear();
+
+  // Cells may have been reallocated by a world load.
+  if (cellClaims.size() != orbis.nCells) {
+    cellClaims.resize(orbis.nCells);
+    Arrays::fill<int, int>(cellClaims.begin(), orbis.nCells * orbis.nCells, -1);
+  }
+
+  const List<int>& objects     = orbis.objectIndices();
+  float            gravityMove = abs(physics.gravity) * Timer::TICK_TIME;
+
+  for (int k = 0; k < objects.size(); ++k) {
+    int           i   = objects[k];
+    const Object* obj = orbis.obj(i);
+
+    if (obj == nullptr || obj->cell == nullptr) {
+      continue;
+    }
+
+    // Scripted and dying objects may do anything, their islands must be updated serially.
+    bool  isSerial = (obj->flags & Object::UPDATE_FUNC_BIT) || obj->life == 0.0f;
+    float reach    = ISLAND_MARGIN;
+
+    if (obj->flags & Object::DYNAMIC_BIT) {
+      const Dynamic* dyn = static_cast<const Dynamic*>(obj);
+
+      reach += (dyn->momentum.fastN() + gravityMove) * Timer::TICK_TIME;
+    }
+    else if (!isSerial) {
+      // Passive static objects are covered by claims of dynamic objects that can hit them.
+      continue;
+    }
+
+    int node = claimObjects.size();
+
+    claimObjects.add(i);
+    claimParents.add(node);
+    claimSerial.add(isSerial);
+
+    claimCells(node, Bounds(*obj, 2.0f * EPSILON + reach));
+  }
+
+  for (int cell : claimedCells) {
+    cellClaims[cell / cellClaims.size()][cell % cellClaims.size()] = -1;
+  }
+  claimedCells.clear();
+
+  int nClaims = claimObjects.size();
+
+  for (int node = 0; node < nClaims; ++node) {
+    if (claimSerial[node]) {
+      claimSerial[findClaim(node)] = true;
+    }
+  }
+
+  claimIslands.resize(nClaims);
+
+  for (int node = 0; node < nClaims; ++node) {
+    int root = findClaim(node);
+
+    if (claimSerial[root]) {
+      claimIslands[node] = -1;
+      continue;
+    }
+
+    if (root == node) {
+      claimIslands[node] = islands.size();
+      islands.add(Island{0, 0});
+    }
+    else {
+      claimIslands[node] = claimIslands[root];
+    }
+    ++islands[claimIslands[node]].nObjects;
+  }
+
+  int nObjects = 0;
+
+  for (Island& island : islands) {
+    island.firstObject = nObjects;
+    nObjects          += island.nObjects;
+    island.nObjects    = 0;
+  }
+
+  islandObjects.resize(nObjects);
+
+  for (int node = 0; node < nClaims; ++node) {
+    if (claimIslands[node] != -1) {
+      Island& island = islands[claimIslands[node]];
+
+      islandObjects[island.firstObject + island.nObjects] = claimObjects[node];
+      islandMembers.set(claimObjects[node]);
+      ++island.nObjects;
+    }
+  }
+}
+
+void Matrix::updateIslands(Worker* worker)
+{
+  int nIslands = islands.size();
+
+  Orbis::deferWakes(&worker->wokenObjects);
+
+  for (int i = nextIsland.fetchAdd<RELAXED>(1); i < nIslands; i = nextIsland.fetchAdd<RELAXED>(1)) {
+    const Island& island = islands[i];
+
+    for (int j = 0; j < island.nObjects; ++j) {
+      Dynamic* dyn = orbis.obj<Dynamic>(islandObjects[island.firstObject + j]);
+
+      OZ_ASSERT(dyn->cell != nullptr);
+
+      worker->physics.updateObj(dyn);
+
+      for (int target : worker->wokenObjects) {
+        worker->wakes.add(Wake{dyn->index, target});
+      }
+      worker->wokenObjects.clear();
+
+      if (dyn->velocity.sqN() > MAX_VELOCITY2) {
+        worker->removals.add(dyn->index);
+      }
+    }
+  }
+
+  Orbis::deferWakes(nullptr);
+}
+
+void Matrix::updateParallel()
+{
+  buildIslands();
+
+  if (islands.isEmpty()) {
+    return;
+  }
+
+  nextIsland.store<RELAXED>(0);
+
+  for (int i = 0; i < nWorkers; ++i) {
+    workers[i].physics.gravity = physics.gravity;
+  }
+  for (int i = 1; i < nWorkers; ++i) {
+    workers[i].semaphore.post();
+  }
+
+  updateIslands(&workers[0]);
+
+  for (int i = 1; i < nWorkers; ++i) {
+    workerSemaphore.wait();
+  }
+
+  // Merge deferred modifications in object index order. They are applied by `finishIsland()` at
+  // the positions the serial loop would have made them.
+  List<Physics::StructDamage>& structDamages = workers[0].structDamages;
+  List<int>&                   removals      = workers[0].removals;
+  List<Wake>&                  wakes         = workers[0].wakes;
+
+  for (int i = 0; i < nWorkers; ++i) {
+    for (int index : workers[i].touches) {
+      orbis.touch(orbis.obj(index));
+    }
+    workers[i].touches.clear();
+  }
+
+  for (int i = 1; i < nWorkers; ++i) {
+    structDamages.addAll(workers[i].structDamages.begin(), workers[i].structDamages.size());
+    removals.addAll(workers[i].removals.begin(), workers[i].removals.size());
+    wakes.addAll(workers[i].wakes.begin(), workers[i].wakes.size());
+
+    workers[i].structDamages.clear();
+    workers[i].removals.clear();
+    workers[i].wakes.clear();
+  }
+
+  structDamages.sort();
+  removals.sort();
+  wakes.sort();
+
+  nextDamage  = 0;
+  nextRemoval = 0;
+  nextWake    = 0;
+}
+
+void Matrix::finishIsland(int index)
+{
+  List<Physics::StructDamage>& structDamages = workers[0].structDamages;
+  List<int>&                   removals      = workers[0].removals;
+  List<Wake>&                  wakes         = workers[0].wakes;
+
+  Dynamic* dyn = orbis.obj<Dynamic>(index);
+
+  // clear inventory of invalid references, physics doesn't depend on it
+  if (dyn != nullptr && !dyn->items.isEmpty() && pruneItems(dyn)) {
+    orbis.touch(dyn);
+  }
+
+  // Changes of objects removed before their turn are dropped, the serial loop wouldn't have
+  // simulated them at all.
+  for (; nextDamage < structDamages.size(); ++nextDamage) {
+    const Physics::StructDamage& structDamage = structDamages[nextDamage];
+
+    if (structDamage.obj > index) {
+      break;
+    }
+
+    if (dyn != nullptr && structDamage.obj == index) {
+      structDamage.str->damage(structDamage.damage);
+      orbis.touch(structDamage.str);
+    }
+  }
+  for (; nextWake < wakes.size() && wakes[nextWake].obj <= index; ++nextWake) {
+    Object* target = orbis.obj(wakes[nextWake].target);
+
+    if (dyn != nullptr && wakes[nextWake].obj == index && target != nullptr) {
+      target->wake();
+    }
+  }
+  for (; nextRemoval < removals.size() && removals[nextRemoval] <= index; ++nextRemoval) {
+    if (dyn != nullptr && removals[nextRemoval] == index) {
+      synapse.remove(dyn);
+    }
+  }
+}
+
+void Matrix::trySleep(Dynamic* dyn)
+{
+  Dynamic* island = nullptr;
+
+  sleepStack.clear();
+
+  // Follow the stack down to an object lying on a floor or on an already sleeping object.
+  for (Dynamic* cur = dyn; cur != nullptr;) {
+    if (cur->flags & Object::SLEEPING_BIT) {
+      island = cur;
+      break;
+    }
+    if (!isResting(cur) || sleepStack.size() == MAX_SLEEP_STACK) {
+      return;
+    }
+
+    sleepStack.add(cur);
+
+    Object* lower = orbis.obj(cur->lower);
+    cur = lower != nullptr && (lower->flags & Object::DYNAMIC_BIT) ?
+          static_cast<Dynamic*>(lower) : nullptr;
+  }
+
+  for (int i = sleepStack.size() - 1; i >= 0; --i) {
+    orbis.sleep(sleepStack[i], island);
+    island = sleepStack[i];
+  }
+}
+
 void Matrix::update()
 {
   maxStructs  = max(maxStructs,  Struct::pool.size());
@@ -38,10 +474,27 @@ void Matrix::update()
   maxVehicles = max(maxVehicles, Vehicle::pool.size());
   maxFrags    = max(maxFrags,    Frag::mpool.size());
 
-  for (int i = 0; i < Orbis::MAX_OBJECTS; ++i) {
-    Object* obj = orbis.obj(i);
+  luaMatrix.update(random.rand(0, INT_MAX));
+
+  // Index lists may grow during the update, so they must be iterated by position.
+  const List<int>& structs = orbis.structIndices();
+  const List<int>& objects = orbis.objectIndices();
+  const List<int>& frags   = orbis.fragIndices();
+
+  // Objects woken during the update are inserted into place, those the list shifts forward must be
+  // skipped.
+  for (int k = 0, last = -1; k < objects.size(); ++k) {
+    if (objects[k] <= last) {
+      continue;
+    }
+    last = objects[k];
+
+    Object* obj = orbis.obj(objects[k]);
 
     if (obj != nullptr) {
+      // Must be checked before events are cleared, objects hit by others only have events.
+      orbis.touchIfActive(obj);
+
       // If this is cleared on the object's update, we may also remove effects added by other
       // objects updated before it.
       obj->events.free();
@@ -54,8 +507,11 @@ void Matrix::update()
     }
   }
 
-  for (int i = 0; i < Orbis::MAX_STRUCTS; ++i) {
-    Struct* str = orbis.str(i);
+  // Open auto-open doors objects have approached during the previous update.
+  orbis.updateTriggers();
+
+  for (int k = 0; k < structs.size(); ++k) {
+    Struct* str = orbis.str(structs[k]);
 
     if (str == nullptr) {
       continue;
@@ -74,9 +530,27 @@ void Matrix::update()
     }
   }
 
-  for (int i = 0; i < Orbis::MAX_OBJECTS; ++i) {
+  physics.integrateObjs(objects);
+
+  // Handler-free islands of dynamic objects are simulated in parallel first, the loop below only
+  // applies their changes to the rest of the world in the same order as the serial update would.
+  if (nWorkers > 1) {
+    updateParallel();
+  }
+
+  for (int k = 0, last = -1; k < objects.size(); ++k) {
+    int     i   = objects[k];
     Object* obj = orbis.obj(i);
 
+    if (i <= last) {
+      continue;
+    }
+    last = i;
+
+    if (islandMembers.get(i)) {
+      finishIsland(i);
+      continue;
+    }
     if (obj == nullptr) {
       continue;
     }
@@ -88,15 +562,8 @@ void Matrix::update()
     }
     else {
       // clear inventory of invalid references
-      if (!obj->items.isEmpty()) {
-        for (int j = 0; j < obj->items.size();) {
-          if (orbis.obj(obj->items[j]) == nullptr) {
-            obj->items.erase(j);
-          }
-          else {
-            ++j;
-          }
-        }
+      if (!obj->items.isEmpty() && pruneItems(obj)) {
+        orbis.touch(obj);
       }
 
       obj->update();
@@ -126,8 +593,19 @@ void Matrix::update()
     }
   }
 
-  for (int i = 0; i < Orbis::MAX_FRAGS; ++i) {
-    Frag* frag = orbis.frag(i);
+  // Resting stacks fall asleep together and are left out of updates until something wakes them.
+  for (int k = 0; k < objects.size(); ++k) {
+    Object* obj = orbis.obj(objects[k]);
+
+    if (obj != nullptr && (obj->flags & Object::DYNAMIC_BIT) &&
+        !(obj->flags & Object::SLEEPING_BIT))
+    {
+      trySleep(static_cast<Dynamic*>(obj));
+    }
+  }
+
+  for (int k = 0; k < frags.size(); ++k) {
+    Frag* frag = orbis.frag(frags[k]);
 
     if (frag == nullptr) {
       continue;
@@ -138,12 +616,21 @@ void Matrix::update()
     }
     else {
       frag->life -= Timer::TICK_TIME;
-      physics.updateFrag(frag);
     }
   }
 
+  if (nWorkers > 1) {
+    workers[0].structDamages.clear();
+    workers[0].removals.clear();
+    workers[0].wakes.clear();
+  }
+
+  physics.updateFrags(frags);
+
   // rotate freeing/waiting/available indices
   orbis.update();
+
+  luaMatrix.stepGarbage();
 }
 
 void Matrix::read(Stream* is)
@@ -184,6 +671,127 @@ Json Matrix::write() const
   return orbis.write();
 }
 
+void Matrix::writeDelta(Stream* os, bool isFull)
+{
+  os->writeUInt64(timer.nTicks);
+  os->writeInt64(timer.duration.ns());
+  orbis.writeDelta(os, isFull);
+  os->writeFloat(physics.gravity);
+}
+
+uint64 Matrix::hash(List<Orbis::Digest>* changes) const
+{
+  Stream os(0);
+  uint64 value = orbis.hash(changes);
+
+  for (int i : orbis.fragIndices()) {
+    const Frag* frag = orbis.frag(i);
+
+    if (frag != nullptr) {
+      os.rewind();
+      frag->write(&os);
+      value += Orbis::digest(i, os);
+    }
+  }
+
+  os.rewind();
+  os.writeUInt64(timer.nTicks);
+  orbis.caelum.write(&os);
+  os.writeFloat(physics.gravity);
+
+  return value + Orbis::digest(-1, os);
+}
+
+void Matrix::writeStateHeader(Stream* os)
+{
+  os->writeUInt(STATE_MAGIC);
+  os->writeInt(STATE_VERSION);
+}
+
+bool Matrix::readState(const File& file, Stream* os)
+{
+  Stream base(0, Endian::LITTLE);
+  if (!file.read(&base)) {
+    return false;
+  }
+
+  base = base.decompress();
+  if (!readStateHeader(&base) || base.available() < int(sizeof(int) + sizeof(uint64))) {
+    return false;
+  }
+
+  int basePos = base.tell();
+
+  base.seek(basePos + int(sizeof(int)));
+  uint64 baseTick = base.readUInt64();
+  base.seek(basePos);
+
+  MergedState  state;
+  List<Stream> deltas;
+
+  if (!mergeDeltas(&base, &state)) {
+    return false;
+  }
+
+  Stream journal(0, Endian::LITTLE);
+  if ((file + ".delta").read(&journal) && readStateHeader(&journal) &&
+      journal.available() >= int(sizeof(uint64)) && journal.readUInt64() == baseTick)
+  {
+    // A chunk cut short by an interrupted save ends the journal.
+    while (journal.available() >= int(sizeof(int))) {
+      int size = journal.readInt();
+      if (size <= 0 || journal.available() < size) {
+        break;
+      }
+
+      const char* chunk = journal.readSkip(size);
+      Stream      delta = Stream(chunk, chunk + size).decompress();
+
+      if (delta.available() == 0 || delta.order() != Endian::LITTLE) {
+        break;
+      }
+
+      // State merged from a damaged delta may be inconsistent, there is no going back.
+      if (!mergeDeltas(&delta, &state)) {
+        return false;
+      }
+      deltas.add(static_cast<Stream&&>(delta));
+    }
+  }
+
+  int nStructs = 0;
+  int nObjects = 0;
+
+  for (const Record& record : state.structs) {
+    nStructs += record.data != nullptr;
+  }
+  for (const Record& record : state.objects) {
+    nObjects += record.data != nullptr;
+  }
+
+  *os = Stream(0, Endian::LITTLE);
+
+  os->write(state.timer, int(sizeof(uint64) + sizeof(int64)));
+  os->write(state.head, state.headSize);
+  os->writeInt(nStructs);
+  os->writeInt(nObjects);
+  // Number of fragments.
+  os->write(state.tail, int(sizeof(int)));
+
+  for (const List<Record>* records : {&state.structs, &state.objects}) {
+    for (const Record& record : *records) {
+      if (record.data != nullptr) {
+        os->write(record.data, record.size);
+      }
+    }
+  }
+
+  os->write(state.tail + sizeof(int), state.tailSize - int(sizeof(int)));
+  os->resize(os->tell());
+  os->rewind();
+  return true;
+}
+
 void Matrix::load()
 {
   Log::print("Loading Matrix ...");
@@ -225,6 +833,24 @@ void Matrix::unload()
   Log::unindent();
   Log::println("}");
 
+  claimedCells.clear();
+  claimedCells.trim();
+  claimObjects.clear();
+  claimObjects.trim();
+  claimParents.clear();
+  claimParents.trim();
+  claimSerial.clear();
+  claimSerial.trim();
+  claimIslands.clear();
+  claimIslands.trim();
+  islands.clear();
+  islands.trim();
+  islandObjects.clear();
+  islandObjects.trim();
+  islandMembers.clear();
+  sleepStack.clear();
+  sleepStack.trim();
+
   synapse.unload();
   orbis.unload();
 
@@ -232,7 +858,7 @@ void Matrix::unload()
   Log::println("}");
 }
 
-void Matrix::init()
+void Matrix::init(int nThreads)
 {
   Log::println("Initialising Matrix {");
   Log::indent();
@@ -240,6 +866,25 @@ void Matrix::init()
   luaMatrix.init();
   orbis.init();
 
+  nWorkers = max(nThreads, 1);
+  workers  = new Worker[nWorkers];
+
+  areWorkersAlive.store<RELAXED>(true);
+
+  for (int i = 0; i < nWorkers; ++i) {
+    workers[i].physics.structDamages = &workers[i].structDamages;
+    workers[i].physics.touches       = &workers[i].touches;
+    workers[i].physics.integrator    = &physics;
+
+    if (i != 0) {
+      workers[i].thread = Thread("matrix", workerMain, &workers[i]);
+    }
+  }
+
+  if (nWorkers > 1) {
+    Log::println("Parallel physics on %d threads", nWorkers);
+  }
+
   Log::unindent();
   Log::println("}");
 }
@@ -249,6 +894,21 @@ void Matrix::destroy()
   Log::println("Destroying Matrix {");
   Log::indent();
 
+  if (workers != nullptr) {
+    areWorkersAlive.store<RELAXED>(false);
+
+    for (int i = 1; i < nWorkers; ++i) {
+      workers[i].semaphore.post();
+      workers[i].thread.join();
+    }
+
+    delete[] workers;
+    workers = nullptr;
+  }
+  nWorkers = 0;
+
+  cellClaims.resize(0);
+
   orbis.destroy();
   luaMatrix.destroy();
 
@@ -23,7 +23,7 @@
 
 #pragma once
 
-#include <matrix/common.hh>
+#include <matrix/Physics.hh>
 
 namespace oz
 {
@@ -33,6 +33,74 @@ class Matrix
 private:
 
   static constexpr float MAX_VELOCITY2 = 1000.0f * 1000.0f;
+  // Slack added to a dynamic object's per-tick reach when it claims cells for its island.
+  static constexpr float ISLAND_MARGIN = 1.0f;
+  // Taller stacks are never put to sleep, also guards against cycles in `lower` references.
+  static constexpr int   MAX_SLEEP_STACK = 64;
+
+  /**
+   * Group of dynamic objects whose physics may interact during a tick.
+   *
+   * Islands never share a cell, so they can be simulated independently. Objects of an island are
+   * stored in `islandObjects[firstObject ... firstObject + nObjects - 1]` in ascending index order.
+   */
+  struct Island
+  {
+    int firstObject;
+    int nObjects;
+  };
+
+  /**
+   * Sleeping object hit on a physics worker, it is woken at the position of the object that hit it.
+   */
+  struct Wake
+  {
+    int obj;
+    int target;
+
+    OZ_ALWAYS_INLINE
+    bool operator<(const Wake& other) const
+    {
+      return obj < other.obj || (obj == other.obj && target < other.target);
+    }
+  };
+
+  /**
+   * Physics worker, the first one runs on the thread calling `update()`.
+   */
+  struct Worker
+  {
+    Thread                      thread;
+    Semaphore                   semaphore;
+    Physics                     physics;
+    List<Physics::StructDamage> structDamages;
+    List<int>                   removals;
+    List<int>                   touches;
+    List<int>                   wokenObjects;
+    List<Wake>                  wakes;
+  };
+
+  Worker*                     workers         = nullptr;
+  int                         nWorkers        = 0;
+  Semaphore                   workerSemaphore;
+  Atomic<bool>                areWorkersAlive = {false};
+  Atomic<int>                 nextIsland      = {0};
+  // Positions in merged lists of deferred changes, see `finishIsland()`.
+  int                         nextDamage      = 0;
+  int                         nextRemoval     = 0;
+  int                         nextWake        = 0;
+
+  // Islands are built by union-find over objects that claim the same cells.
+  Grid<int>                   cellClaims;
+  List<int>                   claimedCells;
+  List<int>                   claimObjects;
+  List<int>                   claimParents;
+  List<bool>                  claimSerial;
+  List<int>                   claimIslands;
+  List<Island>                islands;
+  List<int>                   islandObjects;
+  SBitset<Orbis::MAX_OBJECTS> islandMembers;
+  List<Dynamic*>              sleepStack;
 
   int maxStructs;
   int maxEvents;
@@ -43,6 +111,32 @@ private:
   int maxVehicles;
   int maxFrags;
 
+private:
+
+  static void* workerMain(void* data);
+
+  void workerRun(Worker* worker);
+
+  int findClaim(int node);
+  void claimCells(int node, const Bounds& bounds);
+  void buildIslands();
+  void updateIslands(Worker* worker);
+  void updateParallel();
+  void finishIsland(int index);
+
+  void trySleep(Dynamic* dyn);
+
+public:
+
+  // Leads state files and their journals, the version must be bumped on any change of the format.
+  static constexpr uint STATE_MAGIC   = 0x74537a6f; // "ozSt" in little endian
+  static constexpr int  STATE_VERSION = 1;
+
+public:
+
+  // Simulation's own generator, unaffected by `Math::rand()` calls from other threads.
+  Random random;
+
 public:
 
   void update();
@@ -53,10 +147,52 @@ public:
   void write(Stream* os) const;
   Json write() const;
 
+  /**
+   * Write state in delta format, see `Orbis::writeDelta()`.
+   *
+   * Timer state comes first and gravity last, as in `write()`. Whatever the caller appends to a
+   * delta (e.g. Nirvana and client state) is carried along with gravity.
+   */
+  void writeDelta(Stream* os, bool isFull);
+
+  /**
+   * Write header of a state file or a journal, see `readState()`.
+   */
+  static void writeStateHeader(Stream* os);
+
+  /**
+   * Read saved state as a stream in `write()` format.
+   *
+   * State file holds the compressed header and base, a full delta prefixed by its size. Deltas
+   * written since are appended to the journal `<file>.delta`, which begins with the header and the
+   * tick number of the base and continues with chunks, each the size of a compressed delta
+   * followed by it. Journal is ignored if it belongs to a different base. Records of later deltas
+   * replace those of earlier ones, the rest of the state is taken from the last one. Everything is
+   * little endian.
+   *
+   * @return false if the file cannot be read, has a different format or is damaged.
+   */
+  static bool readState(const File& file, Stream* os);
+
+  /**
+   * Hash of the world state, for checking whether two simulations are in sync.
+   *
+   * Each structure, object and fragment is hashed from its `write()` output and the digests are
+   * summed, so iteration order does not matter. Digests of structures and objects are maintained
+   * incrementally, see `Orbis::hash()`, which also explains `changes`.
+   */
+  uint64 hash(List<Orbis::Digest>* changes = nullptr) const;
+
   void load();
   void unload();
 
-  void init();
+  /**
+   * Initialise matrix.
+   *
+   * @param nThreads number of threads for dynamic object physics, 1 for the serial update that
+   *                 parallel results are checked against.
+   */
+  void init(int nThreads = 1);
   void destroy();
 
 };
@@ -36,14 +36,64 @@ namespace oz
 {
 
 Pool<Object::Event> Object::Event::pool(256);
+SpinLock            Object::Event::poolLock;
 Pool<Object>        Object::pool(16384);
 
+uint64 Object::packPosition(const Point& p)
+{
+  uint64 x = uint64(Math::lround(p.x * 256.0f)) & 0x1fffff;
+  uint64 y = uint64(Math::lround(p.y * 256.0f)) & 0x1fffff;
+  uint64 z = uint64(Math::lround(p.z * 256.0f)) & 0x3fffff;
+
+  return x | y << 21 | z << 42;
+}
+
+Point Object::unpackPosition(uint64 bits)
+{
+  // Shift each field to the top and back to extend its sign.
+  int64 x = int64(bits << 43) >> 43;
+  int64 y = int64(bits << 22) >> 43;
+  int64 z = int64(bits) >> 42;
+
+  return Point(float(x) / 256.0f, float(y) / 256.0f, float(z) / 256.0f);
+}
+
+int16 Object::packVelocity(float velocity)
+{
+  return int16(clamp(Math::lround(velocity * 64.0f), -32767, +32767));
+}
+
+float Object::unpackVelocity(int16 bits)
+{
+  return float(bits) / 64.0f;
+}
+
+uint16 Object::packAngle(float angle)
+{
+  return uint16(Math::lround(angle * (65536.0f / Math::TAU)));
+}
+
+float Object::unpackAngle(uint16 bits)
+{
+  return float(bits) * (Math::TAU / 65536.0f);
+}
+
+ubyte Object::packRatio(float ratio)
+{
+  return ubyte(Math::lround(clamp(ratio, 0.0f, 1.0f) * 255.0f));
+}
+
+float Object::unpackRatio(ubyte bits)
+{
+  return float(bits) / 255.0f;
+}
+
 void Object::onDestroy()
 {
   OZ_ASSERT(cell != nullptr);
 
   if (!clazz->onDestroy.isEmpty()) {
-    luaMatrix.objectCall(clazz->onDestroy, this);
+    luaMatrix.objectCall(clazz->onDestroyIndex, this);
   }
 
   for (int i : items) {
@@ -67,14 +117,14 @@ bool Object::onUse(Bot* user)
 {
   OZ_ASSERT(!clazz->onUse.isEmpty());
 
-  return luaMatrix.objectCall(clazz->onUse, this, user);
+  return luaMatrix.objectCall(clazz->onUseIndex, this, user);
 }
 
 void Object::onUpdate()
 {
   OZ_ASSERT(!clazz->onUpdate.isEmpty());
 
-  luaMatrix.objectCall(clazz->onUpdate, this);
+  luaMatrix.objectCall(clazz->onUpdateIndex, this);
 }
 
 String Object::getTitle() const
@@ -86,10 +136,15 @@ float Object::getStatus() const
 {
   OZ_ASSERT(!clazz->getStatus.isEmpty());
 
-  luaMatrix.objectCall(clazz->getStatus, const_cast<Object*>(this));
+  luaMatrix.objectCall(clazz->getStatusIndex, const_cast<Object*>(this));
   return luaMatrix.objectStatus;
 }
 
+void Object::requestWake()
+{
+  orbis.wake(this);
+}
+
 Object::~Object()
 {
   OZ_ASSERT(dim.x <= REAL_MAX_DIM);
@@ -159,7 +214,7 @@ Object::Object(const ObjectClass* clazz_, Stream* is)
   p          = is->read<Point>();
   dim        = clazz_->dim;
   index      = is->readInt();
-  flags      = is->readInt();
+  flags      = is->readInt() & ~SLEEPING_BIT;
   life       = is->readFloat();
   resistance = clazz_->resistance;
   clazz      = clazz_;
@@ -276,10 +331,18 @@ void Object::write(Stream* os) const
   }
 }
 
-void Object::readUpdate(Stream*)
-{}
+void Object::readUpdate(Stream* is)
+{
+  p     = unpackPosition(is->readUInt64());
+  flags = (flags & ~UPDATE_FLAGS_MASK) | (is->readInt() & UPDATE_FLAGS_MASK);
+  life  = unpackRatio(is->readUByte()) * clazz->life;
+}
 
-void Object::writeUpdate(Stream*) const
-{}
+void Object::writeUpdate(Stream* os) const
+{
+  os->writeUInt64(packPosition(p));
+  os->writeInt(flags & UPDATE_FLAGS_MASK);
+  os->writeUByte(packRatio(life / clazz->life));
+}
 
 }
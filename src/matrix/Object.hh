@@ -119,6 +119,9 @@ public:
   // force full physics update in the next step even if the object should be disabled
   static constexpr int ENABLE_BIT         = 0x00001000;
 
+  // if the object is a part of a sleeping island and is not updated at all until woken
+  static constexpr int SLEEPING_BIT       = 0x00000010;
+
   // if the object is has been sliding on a floor or on another object in last step
   static constexpr int FRICTING_BIT       = 0x00000800;
 
@@ -199,6 +202,7 @@ public:
   public:
 
     static Pool<Event> pool;
+    static SpinLock    poolLock; // Events are also added from parallel physics workers.
 
     int    id;
     float  intensity;
@@ -210,7 +214,23 @@ public:
       : id(id_), intensity(intensity_)
     {}
 
-    OZ_STATIC_POOL_ALLOC(pool)
+    void* operator new(size_t)
+    {
+      poolLock.lock();
+      void* ptr = pool.allocate();
+      poolLock.unlock();
+      return ptr;
+    }
+
+    void operator delete(void* ptr) noexcept
+    {
+      poolLock.lock();
+      pool.deallocate(ptr);
+      poolLock.unlock();
+    }
+
+    void* operator new[](size_t) = delete;
+    void  operator delete[](void*) = delete;
   };
 
 public:
@@ -239,6 +259,29 @@ public:
 
 protected:
 
+  /*
+   * UPDATE QUANTISATION
+   */
+
+  // flags sent in updates, type and function flags never change
+  static constexpr int UPDATE_FLAGS_MASK = 0x0001ffff;
+
+  // positions are sent in 1/256 m units packed into 21 bits for x and y and 22 bits for z
+  static uint64 packPosition(const Point& p);
+  static Point  unpackPosition(uint64 bits);
+
+  // velocities are sent in 1/64 m/s units
+  static int16  packVelocity(float velocity);
+  static float  unpackVelocity(int16 bits);
+
+  // angles are sent as 16-bit fractions of the full circle, unpacked into [0, 2 pi)
+  static uint16 packAngle(float angle);
+  static float  unpackAngle(uint16 bits);
+
+  // ratios in [0, 1] (life, stamina, fuel ...) are sent as 8-bit fractions
+  static ubyte  packRatio(float ratio);
+  static float  unpackRatio(ubyte bits);
+
   /*
    * EVENT HANDLERS
    */
@@ -254,6 +297,10 @@ protected:
   virtual String getTitle() const;
   virtual float getStatus() const;
 
+private:
+
+  void requestWake();
+
 public:
 
   virtual ~Object();
@@ -267,9 +314,23 @@ public:
   OZ_ALWAYS_INLINE
   void addEvent(int id, float intensity)
   {
+    wake();
     events.add(new Event(id, intensity));
   }
 
+  /**
+   * Wake the object's island if the object is sleeping.
+   *
+   * Must be called whenever a sleeping object may be disturbed, e.g. when another object pushes it.
+   */
+  OZ_ALWAYS_INLINE
+  void wake()
+  {
+    if (flags & SLEEPING_BIT) {
+      requestWake();
+    }
+  }
+
   OZ_ALWAYS_INLINE
   void destroy()
   {
@@ -341,7 +402,18 @@ public:
   virtual Json write() const;
   virtual void write(Stream* os) const;
 
+  /**
+   * Read state written by `writeUpdate()`.
+   *
+   * Cell and inventory bookkeeping is left to the caller.
+   */
   virtual void readUpdate(Stream* is);
+
+  /**
+   * Write quantised state that changes during the game, for world snapshots sent to clients.
+   *
+   * Inventories are not written, they follow from items' `parent` indices.
+   */
   virtual void writeUpdate(Stream* os) const;
 
   OZ_STATIC_POOL_ALLOC(pool)
@@ -222,10 +222,15 @@ void ObjectClass::init(const Json& config, const char* name_)
    * handlers
    */
 
-  onDestroy = config["onDestroy"].get("");
-  onUse     = config["onUse"].get("");
-  onUpdate  = config["onUpdate"].get("");
-  getStatus = config["getStatus"].get("");
+  onDestroy      = config["onDestroy"].get("");
+  onUse          = config["onUse"].get("");
+  onUpdate       = config["onUpdate"].get("");
+  getStatus      = config["getStatus"].get("");
+
+  onDestroyIndex = liber.addLuaFunction(onDestroy);
+  onUseIndex     = liber.addLuaFunction(onUse);
+  onUpdateIndex  = liber.addLuaFunction(onUpdate);
+  getStatusIndex = liber.addLuaFunction(getStatus);
 
   if (!onDestroy.isEmpty()) {
     flags |= Object::LUA_BIT;
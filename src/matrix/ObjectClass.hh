@@ -86,6 +86,12 @@ public:
   String                   onUpdate;
   String                   getStatus;
 
+  // Handler indices in `Liber::luaFunctions`.
+  int                      onDestroyIndex;
+  int                      onUseIndex;
+  int                      onUpdateIndex;
+  int                      getStatusIndex;
+
 public:
 
   ObjectClass() = default;
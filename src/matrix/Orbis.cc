@@ -29,7 +29,7 @@ namespace oz
 namespace
 {
 
-static_assert(Orbis::CELLS * Cell::SIZE == Terra::QUADS * Terra::Quad::SIZE,
+static_assert(Orbis::MAX_SIZE == Terra::MAX_QUADS * Terra::Quad::SIZE,
               "oz::Orbis and terrain size mismatch");
 
 /*
@@ -56,62 +56,327 @@ SBitset<Orbis::MAX_STRUCTS> pendingStructs[2];
 SBitset<Orbis::MAX_OBJECTS> pendingObjects[2];
 SBitset<Orbis::MAX_FRAGS>   pendingFrags[2];
 
+/*
+ * Slots that cannot be allocated: occupied ones and those still in 'freeing' or 'waiting' state.
+ * Bits are only cleared when slots leave 'waiting' state, so an allocation is a single bitset scan.
+ */
+SBitset<Orbis::MAX_STRUCTS> takenStructs;
+SBitset<Orbis::MAX_OBJECTS> takenObjects;
+SBitset<Orbis::MAX_FRAGS>   takenFrags;
+
+// Objects whose wakes are deferred by the current thread, see `Orbis::deferWakes()`.
+thread_local List<int>*     wakeDeferrals = nullptr;
+
+// Slots touched since the last delta, removed ones included.
+SBitset<Orbis::MAX_STRUCTS> dirtyStructs;
+SBitset<Orbis::MAX_OBJECTS> dirtyObjects;
+
+/*
+ * Trigger volume, registered in cells within `Object::MAX_DIM` of its bounds. Free slots have
+ * entity -1.
+ */
+struct Trigger
+{
+  Bounds bounds;
+  Span   span;
+  int    entity;
+};
+
+List<Trigger>               triggers;
+// Triggers entered since the last `updateTriggers()`, added from physics workers too.
+List<int>                   triggerHits;
+SpinLock                    triggerLock;
+
+// Slots touched since the last hash and cached digests of the others, 0 for empty slots.
+SBitset<Orbis::MAX_STRUCTS>       unhashedStructs;
+SBitset<Orbis::MAX_OBJECTS>       unhashedObjects;
+SList<uint64, Orbis::MAX_STRUCTS> structDigests(Orbis::MAX_STRUCTS);
+SList<uint64, Orbis::MAX_OBJECTS> objectDigests(Orbis::MAX_OBJECTS);
+uint64                            digestSum = 0;
+
+void touchStruct(int index)
+{
+  dirtyStructs.set(index);
+  unhashedStructs.set(index);
 }
 
-int Orbis::allocStrIndex() const
+void touchObject(int index)
 {
-  int index = lastStructIndex + 1;
+  dirtyObjects.set(index);
+  unhashedObjects.set(index);
+}
 
-  while (structs[index] != nullptr || pendingStructs[0].get(index) || pendingStructs[1].get(index))
-  {
-    if (index == lastStructIndex) {
-      // We have wrapped around => no slots available.
+template <int SIZE>
+int allocIndex(SBitset<SIZE>& taken, int* lastIndex)
+{
+  int index = taken.findFirstZero(*lastIndex + 1);
+
+  if (index == -1) {
+    index = taken.findFirstZero(0);
+
+    if (index == -1) {
+      // No slots available.
       OZ_ASSERT(false);
       return -1;
     }
-
-    index = (index + 1) % MAX_STRUCTS;
   }
 
-  lastStructIndex = index;
+  taken.set(index);
+  *lastIndex = index;
   return index;
 }
 
-int Orbis::allocObjIndex() const
+// Write int placeholder for the size of the block that follows, return its position.
+int beginBlock(Stream* os)
 {
-  int index = lastObjectIndex + 1;
+  int pos = os->tell();
+  os->writeInt(0);
+  return pos;
+}
 
-  while (objects[index] != nullptr || pendingObjects[0].get(index) || pendingObjects[1].get(index))
-  {
-    if (index == lastObjectIndex) {
-      // We have wrapped around => no slots available.
-      OZ_ASSERT(false);
-      return -1;
+// Fill in the size placeholder of a block that ends at the current position.
+void endBlock(Stream* os, int pos)
+{
+  int end = os->tell();
+
+  os->seek(pos);
+  os->writeInt(end - pos - int(sizeof(int)));
+  os->seek(end);
+}
+
+const String& recordName(const Struct* str)
+{
+  return str->bsp->name;
+}
+
+const String& recordName(const Object* obj)
+{
+  return obj->clazz->name;
+}
+
+// Write index and block with name and state of a structure or an object, empty if it's nullptr.
+template <class Elem>
+void writeRecord(Stream* os, int index, const Elem* elem)
+{
+  os->writeInt(index);
+
+  if (elem == nullptr) {
+    os->writeInt(0);
+  }
+  else {
+    int pos = beginBlock(os);
+
+    os->writeString(recordName(elem));
+    elem->write(os);
+
+    endBlock(os, pos);
+  }
+}
+
+void checkTriggers(const Object* obj)
+{
+  if (!(obj->flags & Object::SOLID_BIT)) {
+    return;
+  }
+
+  for (int id : obj->cell->triggers) {
+    if (triggers[id].bounds.overlaps(*obj)) {
+      triggerLock.lock();
+      triggerHits.add(id);
+      triggerLock.unlock();
     }
+  }
+}
+
+// Rehash a structure or an object and update the sum of digests.
+template <class Elem>
+void rehash(Stream* os, int index, const Elem* elem, uint64* digest)
+{
+  uint64 value = 0;
 
-    index = (index + 1) % MAX_OBJECTS;
+  if (elem != nullptr) {
+    os->rewind();
+    elem->write(os);
+    value = Orbis::digest(index, *os);
   }
 
-  lastObjectIndex = index;
-  return index;
+  digestSum += value - *digest;
+  *digest    = value;
 }
 
-int Orbis::allocFragIndex() const
+// Call `func(index)` for each set bit and clear the bitset.
+template <int SIZE, typename Func>
+void consumeBits(SBitset<SIZE>& bits, Func func)
 {
-  int index = lastFragIndex + 1;
+  int base = 0;
 
-  while (frags[index] != nullptr || pendingFrags[0].get(index) || pendingFrags[1].get(index)) {
-    if (index == lastFragIndex) {
-      // We have wrapped around => no slots available.
-      OZ_ASSERT(false);
-      return -1;
+  for (uint64& unit : bits) {
+    for (; unit != 0; unit &= unit - 1) {
+      func(base + __builtin_ctzll(unit));
     }
+    base += int(sizeof(uint64) * 8);
+  }
+}
 
-    index = (index + 1) % MAX_FRAGS;
+void addLive(List<int>* live, List<int>* late, int index)
+{
+  if (live->isEmpty() || live->last() < index) {
+    live->add(index);
+  }
+  else {
+    late->add(index);
   }
+}
 
-  lastFragIndex = index;
-  return index;
+template <typename Elem>
+void updateLive(List<int>* live, List<int>* late, Elem* const* slots)
+{
+  int nLive = 0;
+
+  for (int index : *live) {
+    if (slots[index] != nullptr) {
+      (*live)[nLive++] = index;
+    }
+  }
+
+  int nLate = 0;
+
+  for (int index : *late) {
+    if (slots[index] != nullptr) {
+      (*late)[nLate++] = index;
+    }
+  }
+
+  live->resize(nLive + nLate);
+  late->resize(nLate);
+  late->sort();
+
+  // Merge from the back, so late indices can be put into place without a temporary list.
+  for (int i = nLive - 1, j = nLate - 1, k = nLive + nLate - 1; j >= 0; --k) {
+    if (i >= 0 && (*live)[i] > (*late)[j]) {
+      (*live)[k] = (*live)[i--];
+    }
+    else {
+      (*live)[k] = (*late)[j--];
+    }
+  }
+
+  late->clear();
+}
+
+#ifdef OZ_CELL_BROADPHASE
+
+void eraseSorted(Cell* cell, const Object* obj)
+{
+  for (int i = 0; i < cell->sortedObjects.size(); ++i) {
+    if (cell->sortedObjects[i].obj == obj) {
+      cell->sortedObjects.erase(i);
+      return;
+    }
+  }
+  OZ_ASSERT(false);
+}
+
+#endif
+
+template <int SIZE, typename Elem>
+void resetTaken(SBitset<SIZE>& taken, const SBitset<SIZE>* pending, Elem* const* slots)
+{
+  taken = pending[0] | pending[1];
+
+  for (int i = 0; i < SIZE; ++i) {
+    if (slots[i] != nullptr) {
+      taken.set(i);
+    }
+  }
+}
+
+}
+
+#ifdef OZ_CELL_BROADPHASE
+
+Cell::ObjectRange Cell::objectsNear(float minX, float maxX) const
+{
+  if (!isSorted.load<ACQUIRE>()) {
+    sortLock.lock();
+
+    if (!isSorted.value) {
+      for (Entry& entry : sortedObjects) {
+        entry.x = entry.obj->p.x;
+      }
+
+      // Insertion sort, entries are usually nearly sorted since objects move little per tick. Ties
+      // are broken by index, so the order does not depend on the order of insertions.
+      for (int i = 1; i < sortedObjects.size(); ++i) {
+        Entry entry = sortedObjects[i];
+        int   j     = i;
+
+        for (; j > 0; --j) {
+          const Entry& prev = sortedObjects[j - 1];
+
+          if (prev.x < entry.x || (prev.x == entry.x && prev.obj->index < entry.obj->index)) {
+            break;
+          }
+          sortedObjects[j] = prev;
+        }
+        sortedObjects[j] = entry;
+      }
+
+      isSorted.store<RELEASE>(true);
+    }
+
+    sortLock.unlock();
+  }
+
+  minX -= Object::MAX_DIM;
+  maxX += Object::MAX_DIM;
+
+  const Entry* first = sortedObjects.begin();
+  const Entry* last  = sortedObjects.end();
+
+  for (int count = int(last - first); count > 0;) {
+    int step = count / 2;
+
+    if (first[step].x < minX) {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else {
+      count = step;
+    }
+  }
+
+  const Entry* end = first;
+
+  while (end != last && end->x <= maxX) {
+    ++end;
+  }
+
+  return {ObjectIterator(first), ObjectIterator(end)};
+}
+
+#else
+
+Cell::ObjectRange Cell::objectsNear(float, float) const
+{
+  return {ObjectIterator(objects.first()), ObjectIterator(nullptr)};
+}
+
+#endif
+
+int Orbis::allocStrIndex() const
+{
+  return allocIndex(takenStructs, &lastStructIndex);
+}
+
+int Orbis::allocObjIndex() const
+{
+  return allocIndex(takenObjects, &lastObjectIndex);
+}
+
+int Orbis::allocFragIndex() const
+{
+  return allocIndex(takenFrags, &lastFragIndex);
 }
 
 bool Orbis::position(Struct* str)
@@ -135,11 +400,17 @@ bool Orbis::position(Struct* str)
     }
   }
 
+  // Doors of a demolished structure must not open any more.
+  if (str->demolishing == 0.0f) {
+    addTriggers(str);
+  }
   return true;
 }
 
 void Orbis::unposition(Struct* str)
 {
+  removeTriggers(str);
+
   Span span = getInters(*str, EPSILON);
 
   for (int x = span.minX; x <= span.maxX; ++x) {
@@ -165,12 +436,22 @@ void Orbis::position(Object* obj)
   }
 
   cell->objects.add(obj);
+
+#ifdef OZ_CELL_BROADPHASE
+  cell->sortedObjects.add(Cell::Entry{obj->p.x, obj});
+  cell->isSorted.store<RELAXED>(false);
+#endif
+
+  checkTriggers(obj);
 }
 
 void Orbis::unposition(Object* obj)
 {
   OZ_ASSERT(obj->cell != nullptr);
 
+  // Sleeping islands are linked through their objects, so they must be broken up before.
+  wakeIsland(obj);
+
   Cell* cell = obj->cell;
 
   obj->cell = nullptr;
@@ -180,6 +461,10 @@ void Orbis::unposition(Object* obj)
   }
 
   cell->objects.eraseAfter(obj, obj->prev[0]);
+
+#ifdef OZ_CELL_BROADPHASE
+  eraseSorted(cell, obj);
+#endif
 }
 
 void Orbis::position(Frag* frag)
@@ -222,6 +507,8 @@ Struct* Orbis::add(const BSP* bsp, const Point& p, Heading heading)
 
   Struct* str = new Struct(bsp, index, p, heading);
   structs[index] = str;
+  addLive(&liveStructs, &lateStructs, index);
+  touchStruct(index);
 
   return str;
 }
@@ -235,6 +522,8 @@ Object* Orbis::add(const ObjectClass* clazz, const Point& p, Heading heading)
 
   Object* obj = clazz->create(index, p, heading);
   objects[index] = obj;
+  addLive(&liveObjects, &lateObjects, index);
+  touchObject(index);
 
   if (obj->flags & Object::LUA_BIT) {
     luaMatrix.registerObject(index);
@@ -252,6 +541,7 @@ Frag* Orbis::add(const FragPool* pool, const Point& p, const Vec3& velocity)
 
   Frag* frag = new Frag(pool, index, p, velocity);
   frags[index] = frag;
+  addLive(&liveFrags, &lateFrags, index);
 
   return frag;
 }
@@ -261,6 +551,7 @@ void Orbis::remove(Struct* str)
   OZ_ASSERT(str->index != -1);
 
   pendingStructs[freeing].set(str->index);
+  touchStruct(str->index);
   structs[str->index] = nullptr;
   delete str;
 }
@@ -274,6 +565,8 @@ void Orbis::remove(Object* obj)
   }
 
   pendingObjects[freeing].set(obj->index);
+  touchObject(obj->index);
+  ++Struct::nObjectRemovals;
   objects[obj->index] = nullptr;
   delete obj;
 }
@@ -309,7 +602,18 @@ void Orbis::reposition(Object* obj)
     }
 
     newCell->objects.add(obj);
+
+#ifdef OZ_CELL_BROADPHASE
+    eraseSorted(oldCell, obj);
+    newCell->sortedObjects.add(Cell::Entry{obj->p.x, obj});
+#endif
   }
+
+#ifdef OZ_CELL_BROADPHASE
+  newCell->isSorted.store<RELAXED>(false);
+#endif
+
+  checkTriggers(obj);
 }
 
 void Orbis::reposition(Frag* frag)
@@ -337,6 +641,243 @@ void Orbis::reposition(Frag* frag)
   }
 }
 
+void Orbis::sleep(Dynamic* dyn, Dynamic* island)
+{
+  OZ_ASSERT(dyn->cell != nullptr && !(dyn->flags & Object::SLEEPING_BIT));
+
+  dyn->flags |= Object::SLEEPING_BIT;
+  touchObject(dyn->index);
+
+  if (island == nullptr) {
+    dyn->nextSleeper = dyn->index;
+  }
+  else {
+    OZ_ASSERT(island->flags & Object::SLEEPING_BIT);
+
+    dyn->nextSleeper    = island->nextSleeper;
+    island->nextSleeper = dyn->index;
+    touchObject(island->index);
+  }
+}
+
+void Orbis::addTriggers(const Struct* str)
+{
+  for (const Entity& entity : str->entities) {
+    const EntityClass* clazz = entity.clazz;
+
+    if (clazz->type != EntityClass::DOOR || !(clazz->flags & EntityClass::AUTO_OPEN)) {
+      continue;
+    }
+
+    Bounds  bounds  = Bounds(str->toAbsoluteCS(*clazz), 2.0f * EPSILON + clazz->margin);
+    Trigger trigger = {bounds, getInters(bounds, Object::MAX_DIM), entity.index()};
+    int     id      = 0;
+
+    while (id < triggers.size() && triggers[id].entity != -1) {
+      ++id;
+    }
+
+    if (id == triggers.size()) {
+      triggers.add(trigger);
+    }
+    else {
+      triggers[id] = trigger;
+    }
+
+    for (int x = trigger.span.minX; x <= trigger.span.maxX; ++x) {
+      for (int y = trigger.span.minY; y <= trigger.span.maxY; ++y) {
+        cells[x][y].triggers.add(id);
+      }
+    }
+  }
+}
+
+void Orbis::removeTriggers(const Struct* str)
+{
+  for (int id = 0; id < triggers.size(); ++id) {
+    Trigger& trigger = triggers[id];
+
+    if (trigger.entity == -1 || trigger.entity >> Struct::MAX_ENT_SHIFT != str->index) {
+      continue;
+    }
+
+    for (int x = trigger.span.minX; x <= trigger.span.maxX; ++x) {
+      for (int y = trigger.span.minY; y <= trigger.span.maxY; ++y) {
+        cells[x][y].triggers.excludeUnordered(id);
+      }
+    }
+
+    trigger.entity = -1;
+  }
+}
+
+void Orbis::wake(Object* obj)
+{
+  if (wakeDeferrals != nullptr) {
+    wakeDeferrals->add(obj->index);
+  }
+  else {
+    wakeIsland(obj);
+  }
+}
+
+void Orbis::deferWakes(List<int>* indices)
+{
+  wakeDeferrals = indices;
+}
+
+void Orbis::touch(const Struct* str)
+{
+  touchStruct(str->index);
+}
+
+void Orbis::touch(const Object* obj)
+{
+  touchObject(obj->index);
+}
+
+void Orbis::touchIfActive(const Object* obj)
+{
+  int flags = obj->flags;
+
+  if ((flags & (Object::UPDATE_FUNC_BIT | Object::BOT_BIT | Object::VEHICLE_BIT)) ||
+      !obj->events.isEmpty() ||
+      ((flags & Object::DYNAMIC_BIT) &&
+       (!(flags & Object::DISABLED_BIT) || obj->cell == nullptr)))
+  {
+    touchObject(obj->index);
+  }
+}
+
+void Orbis::clearTouched()
+{
+  dirtyStructs.clear();
+  dirtyObjects.clear();
+}
+
+void Orbis::updateTriggers()
+{
+  // Hits from physics workers come in arbitrary order.
+  triggerHits.sort();
+
+  for (int i = 0; i < triggerHits.size(); ++i) {
+    int id = triggerHits[i];
+
+    if (i == 0 || id != triggerHits[i - 1]) {
+      Entity* entity = ent(triggers[id].entity);
+
+      if (entity != nullptr) {
+        entity->onTrigger();
+      }
+    }
+  }
+
+  triggerHits.clear();
+}
+
+uint64 Orbis::digest(int index, const Stream& os)
+{
+  uint64 value = 14695981039346656037u ^ uint64(index);
+
+  for (const char* c = os.begin(); c < os.pos(); ++c) {
+    value = (value ^ ubyte(*c)) * 1099511628211u;
+  }
+  return value;
+}
+
+uint64 Orbis::hash(List<Digest>* changes)
+{
+  Stream os(0);
+
+  // Objects changed by the last tick's updates may not have been touched yet.
+  for (const List<int>* indices : {&liveObjects, &lateObjects}) {
+    for (int i : *indices) {
+      if (objects[i] != nullptr) {
+        touchIfActive(objects[i]);
+      }
+    }
+  }
+
+  consumeBits(unhashedStructs, [&](int i) {
+    uint64 oldDigest = structDigests[i];
+
+    rehash(&os, i, structs[i], &structDigests[i]);
+
+    if (changes != nullptr && structDigests[i] != oldDigest) {
+      changes->add(Digest{~i, structDigests[i]});
+    }
+  });
+  consumeBits(unhashedObjects, [&](int i) {
+    uint64 oldDigest = objectDigests[i];
+
+    rehash(&os, i, objects[i], &objectDigests[i]);
+
+    if (changes != nullptr && objectDigests[i] != oldDigest) {
+      changes->add(Digest{i, objectDigests[i]});
+    }
+  });
+
+  return digestSum;
+}
+
+void Orbis::wakeIsland(Object* obj)
+{
+  Dynamic* dyn = static_cast<Dynamic*>(obj);
+
+  while (dyn->flags & Object::SLEEPING_BIT) {
+    Dynamic* next = static_cast<Dynamic*>(objects[dyn->nextSleeper]);
+
+    dyn->flags      &= ~Object::SLEEPING_BIT;
+    dyn->nextSleeper = -1;
+    touchObject(dyn->index);
+
+    // Objects put to sleep in this tick have not left the live list yet.
+    int i = Arrays::bisection(sleepingObjects.begin(), sleepingObjects.size(), dyn->index);
+
+    if (i < sleepingObjects.size() && sleepingObjects[i] == dyn->index) {
+      sleepingObjects.erase(i);
+      liveObjects.insert(Arrays::bisection(liveObjects.begin(), liveObjects.size(), dyn->index),
+                         dyn->index);
+    }
+
+    dyn = next;
+  }
+}
+
+void Orbis::updateSleeping()
+{
+  // Woken objects have already been returned to the live list. An index is always either there or
+  // here, never both.
+  int nSleeping = 0;
+
+  for (int index : sleepingObjects) {
+    if (objects[index] != nullptr) {
+      sleepingObjects[nSleeping++] = index;
+    }
+  }
+  sleepingObjects.resize(nSleeping);
+
+  // Move objects put to sleep since the last update out of the live list.
+  for (List<int>* indices : {&liveObjects, &lateObjects}) {
+    int nAwake = 0;
+
+    for (int index : *indices) {
+      const Object* obj = objects[index];
+
+      if (obj != nullptr && (obj->flags & Object::SLEEPING_BIT)) {
+        sleepingObjects.add(index);
+      }
+      else {
+        (*indices)[nAwake++] = index;
+      }
+    }
+    indices->resize(nAwake);
+  }
+
+  // Sorted, so woken objects can be found quickly.
+  sleepingObjects.sort();
+}
+
 void Orbis::resetLastIndices()
 {
   lastStructIndex = -1;
@@ -346,6 +887,16 @@ void Orbis::resetLastIndices()
 
 void Orbis::update()
 {
+  updateSleeping();
+
+  updateLive(&liveStructs, &lateStructs, structs);
+  updateLive(&liveObjects, &lateObjects, objects);
+  updateLive(&liveFrags, &lateFrags, frags);
+
+  takenStructs &= ~pendingStructs[waiting];
+  takenObjects &= ~pendingObjects[waiting];
+  takenFrags   &= ~pendingFrags[waiting];
+
   pendingStructs[waiting].clear();
   pendingObjects[waiting].clear();
   pendingFrags[waiting].clear();
@@ -355,10 +906,46 @@ void Orbis::update()
   caelum.update();
 }
 
+bool Orbis::resize(int size_, int cellSize_)
+{
+  if (!Math::isPow2(size_) || size_ < MIN_SIZE || size_ > MAX_SIZE ||
+      !Math::isPow2(cellSize_) || cellSize_ < MIN_CELL_SIZE || cellSize_ > MAX_CELL_SIZE)
+  {
+    return false;
+  }
+
+  for (const List<int>* indices : {&liveStructs, &lateStructs, &liveObjects, &lateObjects,
+                                   &sleepingObjects, &liveFrags, &lateFrags})
+  {
+    if (!indices->isEmpty()) {
+      return false;
+    }
+  }
+
+  size      = size_;
+  cellSize  = cellSize_;
+  nCells    = size / cellSize;
+  cellScale = 1.0f / float(cellSize);
+
+  mins = Point(-float(size / 2), -float(size / 2), -float(MAX_DIM));
+  maxs = Point(+float(size / 2), +float(size / 2), +float(MAX_DIM));
+
+  cells.resize(nCells);
+  terra.resize(size);
+  return true;
+}
+
 void Orbis::read(Stream* is)
 {
   luaMatrix.read(is);
 
+  int newSize     = is->readInt();
+  int newCellSize = is->readInt();
+
+  if (!resize(newSize, newCellSize)) {
+    OZ_ERROR("Invalid world size %d or cell size %d", newSize, newCellSize);
+  }
+
   caelum.read(is);
   terra.read(is);
 
@@ -374,6 +961,7 @@ void Orbis::read(Stream* is)
 
     position(str);
     structs[str->index] = str;
+    addLive(&liveStructs, &lateStructs, str->index);
   }
 
   for (int i = 0; i < nObjects; ++i) {
@@ -388,6 +976,7 @@ void Orbis::read(Stream* is)
       position(obj);
     }
     objects[obj->index] = obj;
+    addLive(&liveObjects, &lateObjects, obj->index);
   }
 
   for (int i = 0; i < nFrags; ++i) {
@@ -397,6 +986,7 @@ void Orbis::read(Stream* is)
 
     position(frag);
     frags[frag->index] = frag;
+    addLive(&liveFrags, &lateFrags, frag->index);
   }
 
   lastStructIndex = is->readInt();
@@ -409,10 +999,21 @@ void Orbis::read(Stream* is)
   is->readBitset(pendingObjects[waiting]);
   is->readBitset(pendingFrags[freeing]);
   is->readBitset(pendingFrags[waiting]);
+
+  resetTaken(takenStructs, pendingStructs, structs);
+  resetTaken(takenObjects, pendingObjects, objects);
+  resetTaken(takenFrags, pendingFrags, frags);
 }
 
 void Orbis::read(const Json& json)
 {
+  int newSize     = json["size"].get(MAX_SIZE);
+  int newCellSize = json["cellSize"].get(DEFAULT_CELL_SIZE);
+
+  if (!resize(newSize, newCellSize)) {
+    OZ_ERROR("Invalid world size %d or cell size %d", newSize, newCellSize);
+  }
+
   caelum.read(json["caelum"]);
   terra.read(json["terra"]);
 
@@ -425,6 +1026,7 @@ void Orbis::read(const Json& json)
       Struct* str = new Struct(bsp, index, strJson);
       position(str);
       structs[index] = str;
+      addLive(&liveStructs, &lateStructs, index);
     }
   }
 
@@ -445,6 +1047,7 @@ void Orbis::read(const Json& json)
         position(obj);
       }
       objects[obj->index] = obj;
+      addLive(&liveObjects, &lateObjects, obj->index);
 
       for (const Json& itemJson : objJson["items"].arrayCRange()) {
         String              itemName  = itemJson["class"].get("");
@@ -469,6 +1072,7 @@ void Orbis::read(const Json& json)
           }
 
           objects[item->index] = item;
+          addLive(&liveObjects, &lateObjects, item->index);
         }
       }
     }
@@ -495,6 +1099,7 @@ int Orbis::readObject(const Json& json)
     position(obj);
   }
   objects[obj->index] = obj;
+  addLive(&liveObjects, &lateObjects, index);
 
   return index;
 }
@@ -503,6 +1108,9 @@ void Orbis::write(Stream* os) const
 {
   luaMatrix.write(os);
 
+  os->writeInt(size);
+  os->writeInt(cellSize);
+
   caelum.write(os);
   terra.write(os);
 
@@ -515,22 +1123,100 @@ void Orbis::write(Stream* os) const
   os->writeInt(nObjects);
   os->writeInt(nFrags);
 
-  for (const Struct* str : structs) {
-    if (str != nullptr) {
-      os->writeString(str->bsp->name);
-      str->write(os);
+  for (const List<int>* indices : {&liveStructs, &lateStructs}) {
+    for (int i : *indices) {
+      const Struct* str = structs[i];
+
+      if (str != nullptr) {
+        os->writeString(str->bsp->name);
+        str->write(os);
+      }
+    }
+  }
+  for (const List<int>* indices : {&liveObjects, &lateObjects, &sleepingObjects}) {
+    for (int i : *indices) {
+      const Object* obj = objects[i];
+
+      if (obj != nullptr) {
+        os->writeString(obj->clazz->name);
+        obj->write(os);
+      }
+    }
+  }
+  writeFrags(os);
+}
+
+void Orbis::writeDelta(Stream* os, bool isFull)
+{
+  int headPos = beginBlock(os);
+
+  luaMatrix.write(os);
+
+  os->writeInt(size);
+  os->writeInt(cellSize);
+
+  caelum.write(os);
+  terra.write(os);
+
+  endBlock(os, headPos);
+
+  if (isFull) {
+    for (const List<int>* indices : {&liveStructs, &lateStructs}) {
+      for (int i : *indices) {
+        if (structs[i] != nullptr) {
+          writeRecord(os, i, structs[i]);
+        }
+      }
+    }
+    os->writeInt(-1);
+
+    for (const List<int>* indices : {&liveObjects, &lateObjects, &sleepingObjects}) {
+      for (int i : *indices) {
+        if (objects[i] != nullptr) {
+          writeRecord(os, i, objects[i]);
+        }
+      }
     }
+    os->writeInt(-1);
+
+    clearTouched();
   }
-  for (const Object* obj : objects) {
-    if (obj != nullptr) {
-      os->writeString(obj->clazz->name);
-      obj->write(os);
+  else {
+    // Objects changed by the last tick's updates may not have been touched yet.
+    for (const List<int>* indices : {&liveObjects, &lateObjects}) {
+      for (int i : *indices) {
+        if (objects[i] != nullptr) {
+          touchIfActive(objects[i]);
+        }
+      }
     }
+
+    consumeBits(dirtyStructs, [&](int i) {
+      writeRecord(os, i, structs[i]);
+    });
+    os->writeInt(-1);
+
+    consumeBits(dirtyObjects, [&](int i) {
+      writeRecord(os, i, objects[i]);
+    });
+    os->writeInt(-1);
   }
-  for (const Frag* frag : frags) {
-    if (frag != nullptr) {
-      os->writeString(frag->pool->name);
-      frag->write(os);
+
+  os->writeInt(Frag::mpool.size());
+
+  writeFrags(os);
+}
+
+void Orbis::writeFrags(Stream* os) const
+{
+  for (const List<int>* indices : {&liveFrags, &lateFrags}) {
+    for (int i : *indices) {
+      const Frag* frag = frags[i];
+
+      if (frag != nullptr) {
+        os->writeString(frag->pool->name);
+        frag->write(os);
+      }
     }
   }
 
@@ -550,6 +1236,8 @@ Json Orbis::write() const
 {
   Json json(Json::OBJECT);
 
+  json.add("size", size);
+  json.add("cellSize", cellSize);
   json.add("caelum", caelum.write());
   json.add("terra", terra.write());
 
@@ -558,21 +1246,29 @@ Json Orbis::write() const
   Json structsJson = Json::ARRAY;
   Json objectsJson = Json::ARRAY;
 
-  for (const Struct* str : structs) {
-    if (str != nullptr) {
-      structsJson.add(str->write());
+  for (const List<int>* indices : {&liveStructs, &lateStructs}) {
+    for (int i : *indices) {
+      const Struct* str = structs[i];
+
+      if (str != nullptr) {
+        structsJson.add(str->write());
 
-      for (int j : str->boundObjects) {
-        if (objects[j] != nullptr) {
-          boundObjects.add(j);
+        for (int j : str->boundObjects) {
+          if (objects[j] != nullptr) {
+            boundObjects.add(j);
+          }
         }
       }
     }
   }
 
-  for (const Object* obj : objects) {
-    if (obj != nullptr && obj->cell != nullptr && !boundObjects.contains(obj->index)) {
-      objectsJson.add(obj->write());
+  for (const List<int>* indices : {&liveObjects, &lateObjects, &sleepingObjects}) {
+    for (int i : *indices) {
+      const Object* obj = objects[i];
+
+      if (obj != nullptr && obj->cell != nullptr && !boundObjects.contains(obj->index)) {
+        objectsJson.add(obj->write());
+      }
     }
   }
 
@@ -583,27 +1279,66 @@ Json Orbis::write() const
 }
 
 void Orbis::load()
-{}
+{
+  resize(MAX_SIZE, DEFAULT_CELL_SIZE);
+}
 
 void Orbis::unload()
 {
-  for (int i = 0; i < MAX_OBJECTS; ++i) {
-    if (objects[i] != nullptr && (objects[i]->flags & Object::LUA_BIT)) {
-      luaMatrix.unregisterObject(i);
+  for (const List<int>* indices : {&liveObjects, &lateObjects, &sleepingObjects}) {
+    for (int i : *indices) {
+      if (objects[i] != nullptr && (objects[i]->flags & Object::LUA_BIT)) {
+        luaMatrix.unregisterObject(i);
+      }
     }
   }
 
-  for (auto& column : cells) {
-    for (auto& cell : column) {
-      cell.structs.clear();
-      cell.objects.clear();
-      cell.frags.clear();
+  for (Cell& cell : cells) {
+    cell.structs.clear();
+    cell.objects.clear();
+    cell.frags.clear();
+    cell.triggers.clear();
+    cell.triggers.trim();
+#ifdef OZ_CELL_BROADPHASE
+    cell.sortedObjects.clear();
+    cell.sortedObjects.trim();
+    cell.isSorted.store<RELAXED>(true);
+#endif
+  }
+
+  for (const List<int>* indices : {&liveFrags, &lateFrags}) {
+    for (int i : *indices) {
+      delete frags[i];
+      frags[i] = nullptr;
+    }
+  }
+  for (const List<int>* indices : {&liveObjects, &lateObjects, &sleepingObjects}) {
+    for (int i : *indices) {
+      delete objects[i];
+      objects[i] = nullptr;
+    }
+  }
+  for (const List<int>* indices : {&liveStructs, &lateStructs}) {
+    for (int i : *indices) {
+      delete structs[i];
+      structs[i] = nullptr;
     }
   }
 
-  Arrays::free(frags, MAX_FRAGS);
-  Arrays::free(objects, MAX_OBJECTS);
-  Arrays::free(structs, MAX_STRUCTS);
+  liveStructs.clear();
+  liveStructs.trim();
+  liveObjects.clear();
+  liveObjects.trim();
+  liveFrags.clear();
+  liveFrags.trim();
+  lateStructs.clear();
+  lateStructs.trim();
+  lateObjects.clear();
+  lateObjects.trim();
+  sleepingObjects.clear();
+  sleepingObjects.trim();
+  lateFrags.clear();
+  lateFrags.trim();
 
   terra.reset();
   caelum.reset();
@@ -632,17 +1367,33 @@ void Orbis::unload()
   pendingObjects[1].clear();
   pendingFrags[0].clear();
   pendingFrags[1].clear();
+
+  takenStructs.clear();
+  takenObjects.clear();
+  takenFrags.clear();
+
+  dirtyStructs.clear();
+  dirtyObjects.clear();
+
+  triggers.clear();
+  triggers.trim();
+  triggerHits.clear();
+  triggerHits.trim();
+
+  unhashedStructs.clear();
+  unhashedObjects.clear();
+  Arrays::fill<uint64, uint64>(structDigests.begin(), MAX_STRUCTS, 0);
+  Arrays::fill<uint64, uint64>(objectDigests.begin(), MAX_OBJECTS, 0);
+  digestSum = 0;
 }
 
 void Orbis::init()
 {
   Log::print("Initialising Orbis ...");
 
-  mins = Point(-Orbis::DIM, -Orbis::DIM, -Orbis::DIM);
-  maxs = Point(+Orbis::DIM, +Orbis::DIM, +Orbis::DIM);
+  resize(MAX_SIZE, DEFAULT_CELL_SIZE);
 
   caelum.reset();
-  terra.init();
   terra.reset();
 
   Log::printEnd(" OK");
@@ -650,6 +1401,8 @@ void Orbis::init()
 
 void Orbis::destroy()
 {
+  cells.resize(0);
+
   Log::println("Destroying Orbis ... OK");
 }
 
@@ -34,11 +34,116 @@ namespace oz
 
 struct Cell
 {
-  static constexpr int SIZE = 16;
+#ifdef OZ_CELL_BROADPHASE
 
-  SList<int16, 6> structs;
-  Chain<Object>   objects;
-  Chain<Frag>     frags;
+  /**
+   * Broadphase entry, object with its cached x coordinate.
+   */
+  struct Entry
+  {
+    float   x;
+    Object* obj;
+  };
+
+#endif
+
+  /**
+   * Iterator over objects returned by `objectsNear()`.
+   */
+  class ObjectIterator
+  {
+  private:
+
+#ifdef OZ_CELL_BROADPHASE
+    const Entry*  entry;
+#else
+    const Object* obj;
+#endif
+
+  public:
+
+#ifdef OZ_CELL_BROADPHASE
+    OZ_ALWAYS_INLINE
+    explicit ObjectIterator(const Entry* entry_)
+      : entry(entry_)
+    {}
+#else
+    OZ_ALWAYS_INLINE
+    explicit ObjectIterator(const Object* obj_)
+      : obj(obj_)
+    {}
+#endif
+
+    OZ_ALWAYS_INLINE
+    bool operator!=(const ObjectIterator& other) const
+    {
+#ifdef OZ_CELL_BROADPHASE
+      return entry != other.entry;
+#else
+      return obj != other.obj;
+#endif
+    }
+
+    OZ_ALWAYS_INLINE
+    const Object* operator*() const
+    {
+#ifdef OZ_CELL_BROADPHASE
+      return entry->obj;
+#else
+      return obj;
+#endif
+    }
+
+    OZ_ALWAYS_INLINE
+    ObjectIterator& operator++()
+    {
+#ifdef OZ_CELL_BROADPHASE
+      ++entry;
+#else
+      obj = obj->next[0];
+#endif
+      return *this;
+    }
+  };
+
+  struct ObjectRange
+  {
+    ObjectIterator first;
+    ObjectIterator last;
+
+    OZ_ALWAYS_INLINE
+    ObjectIterator begin() const
+    {
+      return first;
+    }
+
+    OZ_ALWAYS_INLINE
+    ObjectIterator end() const
+    {
+      return last;
+    }
+  };
+
+  SList<int16, 6>     structs;
+  Chain<Object>       objects;
+  Chain<Frag>         frags;
+  List<int>           triggers;
+
+#ifdef OZ_CELL_BROADPHASE
+  // Objects sorted by x coordinate. Moved objects only mark the cell as unsorted, entries are
+  // re-sorted lazily when queried, under a lock since queries may come from several threads.
+  mutable List<Entry>  sortedObjects;
+  mutable Atomic<bool> isSorted = {true};
+  mutable SpinLock     sortLock;
+#endif
+
+  /**
+   * Objects whose AABBs may overlap [minX, maxX] interval on the x axis.
+   *
+   * With `OZ_CELL_BROADPHASE` only objects with x coordinates within `Object::MAX_DIM` from the
+   * interval are returned, without it all objects in the cell are.
+   */
+  ObjectRange objectsNear(float minX, float maxX) const;
 };
 
 /**
@@ -51,22 +156,52 @@ class Orbis : public Bounds
 
 public:
 
-  // # of cells on each (x, y) axis
-  static constexpr int DIM         = MAX_WORLD_COORD;
-  static constexpr int CELLS       = 2 * DIM / Cell::SIZE;
-  static constexpr int MAX_STRUCTS = 1 << 10;
-  static constexpr int MAX_OBJECTS = 1 << 15;
-  static constexpr int MAX_FRAGS   = 1 << 12;
+  // World size and cell size are powers of two, chosen when a world is loaded.
+  static constexpr int MAX_DIM           = MAX_WORLD_COORD;
+  static constexpr int MIN_SIZE          = 64;
+  static constexpr int MAX_SIZE          = 2 * MAX_DIM;
+  static constexpr int MIN_CELL_SIZE     = 4;
+  static constexpr int MAX_CELL_SIZE     = 64;
+  static constexpr int DEFAULT_CELL_SIZE = 16;
+  static constexpr int MAX_STRUCTS       = 1 << 10;
+  static constexpr int MAX_OBJECTS       = 1 << 15;
+  static constexpr int MAX_FRAGS         = 1 << 14;
 
-  Caelum  caelum;
-  Terra   terra;
-  Cell    cells[CELLS][CELLS];
+  /**
+   * Digest of a structure or an object as reported by `hash()`.
+   */
+  struct Digest
+  {
+    int    index;
+    uint64 value;
+  };
+
+  Caelum     caelum;
+  Terra      terra;
+  Grid<Cell> cells;
+
+  int        size      = 0;    ///< Length of world on x and y axes.
+  int        cellSize  = 0;    ///< Length of a cell.
+  int        nCells    = 0;    ///< Number of cells on x and y axes.
+  float      cellScale = 0.0f; ///< Inverse cell size.
 
 private:
 
-  Struct* structs[MAX_STRUCTS];
-  Object* objects[MAX_OBJECTS];
-  Frag*   frags[MAX_FRAGS];
+  Struct*   structs[MAX_STRUCTS];
+  Object*   objects[MAX_OBJECTS];
+  Frag*     frags[MAX_FRAGS];
+
+  // Dense lists of used slots in ascending order. Removed slots are dropped on `update()`. Indices
+  // allocated below the last one (after allocation wraps around) are kept aside until then too, so
+  // lists are only appended to while the world is being updated.
+  List<int> liveStructs;
+  List<int> liveObjects;
+  List<int> liveFrags;
+  List<int> lateStructs;
+  List<int> lateObjects;
+  List<int> lateFrags;
+  // Objects of sleeping islands, moved out of `liveObjects` on `update()`.
+  List<int> sleepingObjects;
 
 private:
 
@@ -91,11 +226,155 @@ private:
   void remove(Object* obj);
   void remove(Frag* frag);
 
+  void wakeIsland(Object* obj);
+  void updateSleeping();
+
+  void addTriggers(const Struct* str);
+
+  void writeFrags(Stream* os) const;
+
 public:
 
   void reposition(Object* obj);
   void reposition(Frag* frag);
 
+  /**
+   * Remove triggers of a structure's auto-open doors, when it starts being demolished.
+   */
+  void removeTriggers(const Struct* str);
+
+  /**
+   * Refresh broadphase key of an object whose position was changed and restored in place, without
+   * `reposition()`.
+   */
+  void resort(const Object* obj)
+  {
+#ifdef OZ_CELL_BROADPHASE
+    if (obj->cell != nullptr) {
+      obj->cell->isSorted.store<RELAXED>(false);
+    }
+#else
+    static_cast<void>(obj);
+#endif
+  }
+
+  /**
+   * Put a resting dynamic object to sleep, joining the island of another sleeping object if given.
+   *
+   * Sleeping objects are dropped from `objectIndices()` on the next `update()` and stay out of it
+   * until their island is woken.
+   */
+  void sleep(Dynamic* dyn, Dynamic* island);
+
+  /**
+   * Wake the island of a sleeping object.
+   *
+   * Woken objects are put back into `objectIndices()` at once, so those after the object being
+   * updated are still updated in this tick. On threads that defer wakes the object is only added
+   * to their list.
+   */
+  void wake(Object* obj);
+
+  /**
+   * Make `wake()` calls from this thread only add objects to a given list, `nullptr` to stop.
+   *
+   * Physics workers defer wakes, since they must not modify index lists.
+   */
+  static void deferWakes(List<int>* indices);
+
+  /**
+   * Mark structure as changed, so it is written in the next `writeDelta()`.
+   *
+   * Not safe to call from physics workers.
+   */
+  void touch(const Struct* str);
+
+  /**
+   * Mark object as changed, so it is written in the next `writeDelta()`.
+   *
+   * Not safe to call from physics workers.
+   */
+  void touch(const Object* obj);
+
+  /**
+   * Touch object if it may change without anyone touching it: it is simulated, carried in an
+   * inventory, has an update handler or pending events.
+   */
+  void touchIfActive(const Object* obj);
+
+  /**
+   * Clear touched marks, as if state had been written by `writeDelta()`.
+   */
+  void clearTouched();
+
+  /**
+   * Notify entities whose trigger volumes solid objects have entered since the last call.
+   *
+   * Auto-open doors have trigger volumes, their bounds extended by the margin, registered in the
+   * cells they may overlap objects from. Objects check triggers of their cells when positioned or
+   * moved, so closed doors don't have to poll for objects.
+   */
+  void updateTriggers();
+
+  /**
+   * FNV-1a hash of bytes written to a stream, seeded by an index.
+   */
+  static uint64 digest(int index, const Stream& os);
+
+  /**
+   * Sum of digests of all structures and objects.
+   *
+   * Digests are cached and only structures and objects touched since the previous call are
+   * rehashed, so the result is only correct if all changes are touched, the same as for
+   * `writeDelta()`. Changed digests are appended to `changes` if given, structures with indices
+   * `~index`.
+   */
+  uint64 hash(List<Digest>* changes = nullptr);
+
+  /**
+   * Indices of structures in ascending order.
+   *
+   * Structures removed in this tick may still be listed, so `str()` must be checked for nullptr.
+   * Iterate by position, the list may be appended to as new structures are added.
+   */
+  OZ_ALWAYS_INLINE
+  const List<int>& structIndices() const
+  {
+    return liveStructs;
+  }
+
+  /**
+   * Indices of awake objects in ascending order, same rules apply as for `structIndices()`.
+   *
+   * Objects put to sleep in this tick may still be listed. Woken objects are inserted in place, so
+   * iterations must skip indices that are not greater than the last one visited.
+   */
+  OZ_ALWAYS_INLINE
+  const List<int>& objectIndices() const
+  {
+    return liveObjects;
+  }
+
+  /**
+   * Indices of objects in sleeping islands in ascending order.
+   *
+   * Objects put to sleep in this tick are only added on the next `update()`.
+   */
+  OZ_ALWAYS_INLINE
+  const List<int>& sleepingIndices() const
+  {
+    return sleepingObjects;
+  }
+
+  /**
+   * Indices of fragments in ascending order, same rules apply as for `structIndices()`.
+   */
+  OZ_ALWAYS_INLINE
+  const List<int>& fragIndices() const
+  {
+    return liveFrags;
+  }
+
   /**
    * Return structure at a given index, nullptr if index is -1.
    */
@@ -211,11 +490,11 @@ public:
   OZ_ALWAYS_INLINE
   Cell* getCell(float x, float y)
   {
-    int ix = int((x + Orbis::DIM) / Cell::SIZE);
-    int iy = int((y + Orbis::DIM) / Cell::SIZE);
+    int ix = int((x + maxs.x) * cellScale);
+    int iy = int((y + maxs.y) * cellScale);
 
-    ix = clamp(ix, 0, Orbis::CELLS - 1);
-    iy = clamp(iy, 0, Orbis::CELLS - 1);
+    ix = clamp(ix, 0, nCells - 1);
+    iy = clamp(iy, 0, nCells - 1);
 
     return &cells[ix][iy];
   }
@@ -243,10 +522,10 @@ public:
                  float epsilon = 0.0f) const
   {
     return {
-      max(int((minPosX - epsilon + Orbis::DIM) / Cell::SIZE), 0),
-      max(int((minPosY - epsilon + Orbis::DIM) / Cell::SIZE), 0),
-      min(int((maxPosX + epsilon + Orbis::DIM) / Cell::SIZE), Orbis::CELLS - 1),
-      min(int((maxPosY + epsilon + Orbis::DIM) / Cell::SIZE), Orbis::CELLS - 1)
+      max(int((minPosX - epsilon + maxs.x) * cellScale), 0),
+      max(int((minPosY - epsilon + maxs.y) * cellScale), 0),
+      min(int((maxPosX + epsilon + maxs.x) * cellScale), nCells - 1),
+      min(int((maxPosY + epsilon + maxs.y) * cellScale), nCells - 1)
     };
   }
 
@@ -266,6 +545,14 @@ public:
   void resetLastIndices();
   void update();
 
+  /**
+   * Set world size and cell size, reallocating cells if the number of cells changes.
+   *
+   * World spans [-size/2, +size/2] on x and y axes and keeps the maximum extent on z axis. Both
+   * sizes must be powers of two within limits and the world must be empty. Return false otherwise.
+   */
+  bool resize(int size_, int cellSize_);
+
   void read(Stream* is);
   void read(const Json& json);
   int readObject(const Json& json);
@@ -273,6 +560,19 @@ public:
   void write(Stream* os) const;
   Json write() const;
 
+  /**
+   * Write state in delta format and clear touched marks.
+   *
+   * Lua, world and cell sizes, caelum and terrain come first as a block prefixed by its size.
+   * Structure and object records follow, each list terminated by index -1. A record is an index,
+   * size and bytes as `write()` outputs them for that structure or object, size 0 meaning it has
+   * been removed. The rest equals the remainder of `write()` output, beginning with the number of
+   * fragments.
+   *
+   * Only structures and objects touched since the previous delta get records unless `isFull`.
+   */
+  void writeDelta(Stream* os, bool isFull);
+
   void load();
   void unload();
 
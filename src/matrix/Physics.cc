@@ -19,6 +19,8 @@
 
 #include <matrix/Physics.hh>
 
+#include <matrix/Matrix.hh>
+
 namespace oz
 {
 
@@ -26,6 +28,17 @@ namespace oz
 //*    OBJECT COLLISION HANDLING    *
 //***********************************
 
+void Physics::touch(const Object* obj)
+{
+  // Touching is not safe on workers, adjacent objects share words of Orbis dirty bitsets.
+  if (touches != nullptr) {
+    touches->add(obj->index);
+  }
+  else {
+    orbis.touch(obj);
+  }
+}
+
 bool Physics::handleObjFriction()
 {
   float systemMom = gravity * Timer::TICK_TIME;
@@ -149,6 +162,9 @@ void Physics::handleObjHit()
   if (hit.obj != nullptr && (hit.obj->flags & Object::DYNAMIC_BIT)) {
     Dynamic* sDyn = static_cast<Dynamic*>(hit.obj);
 
+    // It may be disabled and wouldn't be touched otherwise, but flags and momentum change below.
+    touch(sDyn);
+
     float massSum     = dyn->mass + sDyn->mass;
     Vec3  momentum    = (dyn->momentum * dyn->mass + sDyn->momentum * sDyn->mass) / massSum;
     float hitMomentum = (dyn->momentum - sDyn->momentum) * hit.normal;
@@ -180,6 +196,7 @@ void Physics::handleObjHit()
       dyn->momentum.y -= (dynMomProj - sDynVelProj) * hit.normal.y;
 
       sDyn->flags      &= ~Object::DISABLED_BIT;
+      sDyn->wake();
       sDyn->momentum.x += directPushX;
       sDyn->momentum.y += directPushY;
 
@@ -201,6 +218,7 @@ void Physics::handleObjHit()
       dyn->momentum.z  = sDyn->velocity.z;
 
       sDyn->flags     &= ~(Object::DISABLED_BIT | Object::ON_FLOOR_BIT);
+      sDyn->wake();
       sDyn->lower      = dyn->index;
       sDyn->floor      = Vec3(0.0f, 0.0f, 1.0f);
       sDyn->momentum.z = momentum.z;
@@ -217,6 +235,7 @@ void Physics::handleObjHit()
 
       if (!(sDyn->flags & Object::ON_FLOOR_BIT) && sDyn->lower == -1) {
         sDyn->flags     &= ~Object::DISABLED_BIT;
+        sDyn->wake();
         sDyn->momentum.z = momentum.z;
       }
     }
@@ -240,7 +259,13 @@ void Physics::handleObjHit()
         hit.obj->damage(damage);
       }
       else if (hit.str != nullptr) {
-        hit.str->damage(damage);
+        if (structDamages != nullptr) {
+          structDamages->add(StructDamage{dyn->index, structDamages->size(), hit.str, damage});
+        }
+        else {
+          hit.str->damage(damage);
+          orbis.touch(hit.str);
+        }
       }
     }
 
@@ -372,8 +397,9 @@ void Physics::handleFragHit()
         float damage = FRAG_DAMAGE_COEF * velocity2 * frag->mass;
 
         if (damage > str->resistance) {
-          damage *= Math::rand(FRAG_FIXED_DAMAGE, 1.0f);
+          damage *= matrix.random.rand(FRAG_FIXED_DAMAGE, 1.0f);
           str->damage(damage);
+          orbis.touch(str);
         }
       }
       else if (collider.hit.obj != nullptr) {
@@ -381,7 +407,7 @@ void Physics::handleFragHit()
         float damage = FRAG_DAMAGE_COEF * velocity2 * frag->mass;
 
         if (damage > obj->resistance) {
-          damage *= Math::rand(FRAG_FIXED_DAMAGE, 1.0f);
+          damage *= matrix.random.rand(FRAG_FIXED_DAMAGE, 1.0f);
           obj->damage(damage);
         }
 
@@ -392,6 +418,7 @@ void Physics::handleFragHit()
           float massSum  = fragMass + dynObj->mass;
 
           dynObj->flags   &= ~Object::DISABLED_BIT;
+          dynObj->wake();
           dynObj->momentum = (fragVelocity * fragMass + dynObj->momentum * dynObj->mass) / massSum;
         }
       }
@@ -441,6 +468,126 @@ void Physics::handleFragMove()
 //*             PUBLIC              *
 //***********************************
 
+void Physics::integrateObjs(const List<int>& objIndices)
+{
+  packed.objs.clear();
+  packed.indices.clear();
+  packed.integrated.clear();
+
+  for (int index : objIndices) {
+    Dynamic* dyn = orbis.obj<Dynamic>(index);
+
+    if (dyn == nullptr || dyn->cell == nullptr || dyn->life == 0.0f || dyn->lower != -1 ||
+        (dyn->flags & (Object::DISABLED_BIT | Object::UPDATE_FUNC_BIT | Object::ON_FLOOR_BIT |
+                       Object::ON_LADDER_BIT)) ||
+        !(dyn->flags & Object::DYNAMIC_BIT))
+    {
+      continue;
+    }
+
+    packed.objs.add(dyn);
+    packed.indices.add(index);
+    packed.integrated.set(index);
+  }
+
+  int nObjs    = packed.objs.size();
+  int nPadded  = (nObjs + 3) & ~3;
+  int nPadding = nPadded - nObjs;
+
+  packed.deltas.resize(nObjs);
+
+  packed.momentumX.resize(nPadded);
+  packed.momentumY.resize(nPadded);
+  packed.momentumZ.resize(nPadded);
+  packed.dragRatios.resize(nPadded);
+  packed.systemMomenta.resize(nPadded);
+
+  for (int i = 0; i < nObjs; ++i) {
+    const Dynamic* dyn       = packed.objs[i];
+    float          systemMom = gravity * Timer::TICK_TIME;
+    float          dragRatio = 1.0f;
+
+    // The same as in handleObjFriction().
+    if (dyn->flags & Object::IN_LIQUID_BIT) {
+      float lift = dyn->flags & Object::IN_LAVA_BIT ? LAVA_LIFT : dyn->lift;
+      float frictionFactor = 0.5f * dyn->depth / dyn->dim.z;
+
+      dragRatio  = 1.0f - frictionFactor * WATER_FRICTION;
+      systemMom -= frictionFactor * lift * gravity * Timer::TICK_TIME;
+    }
+
+    packed.momentumX[i]     = dyn->momentum.x;
+    packed.momentumY[i]     = dyn->momentum.y;
+    packed.momentumZ[i]     = dyn->momentum.z;
+    packed.dragRatios[i]    = dragRatio;
+    packed.systemMomenta[i] = systemMom;
+  }
+  for (int i = nObjs; i < nObjs + nPadding; ++i) {
+    packed.momentumX[i]     = 0.0f;
+    packed.momentumY[i]     = 0.0f;
+    packed.momentumZ[i]     = 0.0f;
+    packed.dragRatios[i]    = 1.0f;
+    packed.systemMomenta[i] = 0.0f;
+  }
+
+#ifdef OZ_SIMD
+
+  float4* momentaX = reinterpret_cast<float4*>(packed.momentumX.begin());
+  float4* momentaY = reinterpret_cast<float4*>(packed.momentumY.begin());
+  float4* momentaZ = reinterpret_cast<float4*>(packed.momentumZ.begin());
+
+  const float4* dragRatios    = reinterpret_cast<const float4*>(packed.dragRatios.begin());
+  const float4* systemMomenta = reinterpret_cast<const float4*>(packed.systemMomenta.begin());
+
+  for (int i = 0; i < nPadded / 4; ++i) {
+    float4 x = momentaX[i] * dragRatios[i];
+    float4 y = momentaY[i] * dragRatios[i];
+    float4 z = momentaZ[i] * dragRatios[i] + systemMomenta[i];
+
+    // Objects floating still stick.
+    uint4 isStill = uint4(vAbs(systemMomenta[i]) <= vFill(FLOATING_STICK_VELOCITY)) &
+                    uint4(x*x + y*y + z*z <= vFill(FLOATING_STICK_VELOCITY));
+
+    momentaX[i] = float4(~isStill & uint4(x));
+    momentaY[i] = float4(~isStill & uint4(y));
+    momentaZ[i] = float4(~isStill & uint4(z));
+  }
+
+#else
+
+  for (int i = 0; i < nObjs; ++i) {
+    float x = packed.momentumX[i] * packed.dragRatios[i];
+    float y = packed.momentumY[i] * packed.dragRatios[i];
+    float z = packed.momentumZ[i] * packed.dragRatios[i] + packed.systemMomenta[i];
+
+    // Objects floating still stick.
+    if (abs(packed.systemMomenta[i]) <= FLOATING_STICK_VELOCITY &&
+        x*x + y*y + z*z <= FLOATING_STICK_VELOCITY)
+    {
+      x = 0.0f;
+      y = 0.0f;
+      z = 0.0f;
+    }
+
+    packed.momentumX[i] = x;
+    packed.momentumY[i] = y;
+    packed.momentumZ[i] = z;
+  }
+
+#endif
+
+  for (int i = 0; i < nObjs; ++i) {
+    Dynamic* dyn      = packed.objs[i];
+    Vec3     momentum = Vec3(packed.momentumX[i], packed.momentumY[i], packed.momentumZ[i]);
+
+    packed.deltas[i] = momentum - dyn->momentum;
+
+    if (momentum != dyn->momentum) {
+      dyn->momentum = momentum;
+    }
+  }
+}
+
 void Physics::updateEnt(Entity* ent, const Vec3& localMove)
 {
   const EntityClass* clazz = ent->clazz;
@@ -460,6 +607,7 @@ void Physics::updateEnt(Entity* ent, const Vec3& localMove)
 
         sDyn->momentum -= 8.0f * collider.hit.normal;
         sDyn->flags    &= ~Object::DISABLED_BIT;
+        sDyn->wake();
       }
     }
 
@@ -503,9 +651,27 @@ void Physics::updateObj(Dynamic* dyn_)
     }
   }
 
-  // Handle physics.
+  // Handle physics. Friction for free-floating objects has already been integrated in bulk, unless
+  // they have since been hit from below and rest on the hitting object. Their bulk integration is
+  // undone, so they get friction the same as if they have not been free-floating.
   if (!(dyn->flags & Object::DISABLED_BIT)) {
-    if (handleObjFriction()) {
+    const Packed& bulk         = integrator == nullptr ? packed : integrator->packed;
+    bool          isIntegrated = bulk.integrated.get(dyn->index);
+
+    if (isIntegrated && dyn->lower != -1) {
+      int i = Arrays::bisection(bulk.indices.begin(), bulk.indices.size(), dyn->index);
+
+      OZ_ASSERT(i < bulk.indices.size() && bulk.indices[i] == dyn->index);
+
+      dyn->momentum -= bulk.deltas[i];
+      isIntegrated   = false;
+    }
+
+    bool isMoving = isIntegrated ?
+                    dyn->momentum != Vec3::ZERO || (dyn->flags & Object::ENABLE_BIT) :
+                    handleObjFriction();
+
+    if (isMoving) {
       int oldFlags = dyn->flags;
 
       dyn->flags &= ~(Object::MOVE_CLEAR_MASK | Object::ENABLE_BIT);
@@ -564,6 +730,101 @@ void Physics::updateFrag(Frag* frag_)
   handleFragMove();
 }
 
+void Physics::updateFrags(const List<int>& fragIndices)
+{
+  PackedFrags& pf = packedFrags;
+
+  pf.frags.clear();
+
+  for (int index : fragIndices) {
+    Frag* frag = orbis.frag(index);
+
+    if (frag != nullptr) {
+      OZ_ASSERT(frag->cell != nullptr);
+
+      pf.frags.add(frag);
+    }
+  }
+
+  int nFrags  = pf.frags.size();
+  int nPadded = (nFrags + 3) & ~3;
+
+  for (List<float>* list : {&pf.positionX, &pf.positionY, &pf.positionZ,
+                            &pf.velocityX, &pf.velocityY, &pf.velocityZ})
+  {
+    list->resize(nPadded);
+  }
+
+  for (int i = 0; i < nFrags; ++i) {
+    const Frag* frag = pf.frags[i];
+
+    pf.positionX[i] = frag->p.x;
+    pf.positionY[i] = frag->p.y;
+    pf.positionZ[i] = frag->p.z;
+    pf.velocityX[i] = frag->velocity.x;
+    pf.velocityY[i] = frag->velocity.y;
+    pf.velocityZ[i] = frag->velocity.z;
+  }
+  for (int i = nFrags; i < nPadded; ++i) {
+    pf.positionX[i] = 0.0f;
+    pf.positionY[i] = 0.0f;
+    pf.positionZ[i] = 0.0f;
+    pf.velocityX[i] = 0.0f;
+    pf.velocityY[i] = 0.0f;
+    pf.velocityZ[i] = 0.0f;
+  }
+
+  // Positions become end positions of the moves.
+#ifdef OZ_SIMD
+
+  float4* positionsX  = reinterpret_cast<float4*>(pf.positionX.begin());
+  float4* positionsY  = reinterpret_cast<float4*>(pf.positionY.begin());
+  float4* positionsZ  = reinterpret_cast<float4*>(pf.positionZ.begin());
+  float4* velocitiesX = reinterpret_cast<float4*>(pf.velocityX.begin());
+  float4* velocitiesY = reinterpret_cast<float4*>(pf.velocityY.begin());
+  float4* velocitiesZ = reinterpret_cast<float4*>(pf.velocityZ.begin());
+
+  for (int i = 0; i < nPadded / 4; ++i) {
+    velocitiesZ[i] += vFill(gravity * Timer::TICK_TIME);
+
+    positionsX[i] += velocitiesX[i] * vFill(Timer::TICK_TIME);
+    positionsY[i] += velocitiesY[i] * vFill(Timer::TICK_TIME);
+    positionsZ[i] += velocitiesZ[i] * vFill(Timer::TICK_TIME);
+  }
+
+#else
+
+  for (int i = 0; i < nFrags; ++i) {
+    pf.velocityZ[i] += gravity * Timer::TICK_TIME;
+
+    pf.positionX[i] += pf.velocityX[i] * Timer::TICK_TIME;
+    pf.positionY[i] += pf.velocityY[i] * Timer::TICK_TIME;
+    pf.positionZ[i] += pf.velocityZ[i] * Timer::TICK_TIME;
+  }
+
+#endif
+
+  for (int i = 0; i < nFrags; ++i) {
+    Point end = Point(pf.positionX[i], pf.positionY[i], pf.positionZ[i]);
+
+    frag = pf.frags[i];
+    frag->velocity.z = pf.velocityZ[i];
+
+    Bounds sweep = Bounds(Point(min(frag->p.x, end.x), min(frag->p.y, end.y),
+                                min(frag->p.z, end.z)),
+                          Point(max(frag->p.x, end.x), max(frag->p.y, end.y),
+                                max(frag->p.z, end.z)));
+
+    if (collider.mayOverlap(Bounds(sweep, 2.0f * EPSILON))) {
+      handleFragMove();
+    }
+    else {
+      frag->p = end;
+      orbis.reposition(frag);
+    }
+  }
+}
+
 Physics physics;
 
 }
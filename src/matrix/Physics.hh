@@ -67,19 +67,85 @@ public:
   static constexpr float FRAG_DAMAGE_COEF        =  0.05f;
   static constexpr float FRAG_FIXED_DAMAGE       =  0.75f;
 
+  /**
+   * Structure damage postponed until the end of a parallel physics pass.
+   */
+  struct StructDamage
+  {
+    int     obj;    ///< Index of the object that inflicted the damage.
+    int     order;  ///< Sequence number, to keep multiple hits of the same object ordered.
+    Struct* str;
+    float   damage;
+
+    OZ_ALWAYS_INLINE
+    bool operator<(const StructDamage& other) const
+    {
+      return obj < other.obj || (obj == other.obj && order < other.order);
+    }
+  };
+
 private:
 
-  Dynamic* dyn;
-  Frag*    frag;
-  Vec3     move;
-  Vec3     lastNormals[2];
+  /**
+   * Packed mirror of the hot state of dynamic objects in the air or in liquid.
+   *
+   * Gravity and liquid drag for such objects are integrated over these arrays four objects at a
+   * time (if built with `OZ_SIMD`). Momenta are written back to objects only when changed, the
+   * changes are kept in `deltas` so they can be undone for objects that land on something before
+   * they are updated.
+   */
+  struct Packed
+  {
+    List<Dynamic*>              objs;
+    List<int>                   indices;
+    List<Vec3>                  deltas;
+    List<float>                 momentumX;
+    List<float>                 momentumY;
+    List<float>                 momentumZ;
+    List<float>                 dragRatios;
+    List<float>                 systemMomenta;
+    SBitset<Orbis::MAX_OBJECTS> integrated;
+  };
+
+  /**
+   * Packed mirror of fragment positions and velocities.
+   *
+   * Gravity and moves of all fragments are integrated over these arrays in one pass, only those
+   * whose swept bounds may hit something are traced by the collider.
+   */
+  struct PackedFrags
+  {
+    List<Frag*> frags;
+    List<float> positionX;
+    List<float> positionY;
+    List<float> positionZ;
+    List<float> velocityX;
+    List<float> velocityY;
+    List<float> velocityZ;
+  };
+
+  Packed              packed;
+  PackedFrags         packedFrags;
+
+  Dynamic*            dyn;
+  Frag*               frag;
+  Vec3                move;
+  Vec3                lastNormals[2];
 
 public:
 
-  float    gravity = -9.81f;
+  float               gravity       = -9.81f;
+  /// If set, structure hits are appended here instead of damaging structures immediately.
+  List<StructDamage>* structDamages = nullptr;
+  /// If set, indices of other objects changed by hits are appended here instead of touching them.
+  List<int>*          touches       = nullptr;
+  /// If set, objects are integrated by `integrateObjs()` of this instance rather than this one.
+  const Physics*      integrator    = nullptr;
 
 private:
 
+  void touch(const Object* obj);
+
   bool handleObjFriction();
   void handleObjHit();
   Vec3 handleObjMove();
@@ -89,10 +155,24 @@ private:
 
 public:
 
+  /**
+   * Integrate gravity and liquid drag for all free-floating dynamic objects in one pass.
+   *
+   * Must be called before any `updateObj()` in a tick, objects handled here skip the equivalent
+   * step in `updateObj()`. Objects with update handlers are left alone, since their handlers
+   * usually change momentum before physics.
+   */
+  void integrateObjs(const List<int>& objIndices);
+
   void updateEnt(Entity* ent, const Vec3& localMove);
   void updateObj(Dynamic* dyn_);
   void updateFrag(Frag* frag_);
 
+  /**
+   * Update all existing fragments among given indices, the same as `updateFrag()` on each.
+   */
+  void updateFrags(const List<int>& fragIndices);
+
 };
 
 extern Physics physics;
@@ -0,0 +1,206 @@
+/*
+ * OpenZone - simple cross-platform FPS/RTS game engine.
+ *
+ * Copyright © 2002-2019 Davorin Učakar
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <matrix/Replay.hh>
+
+#include <matrix/Matrix.hh>
+
+#include <climits>
+
+namespace oz
+{
+
+bool Replay::Input::operator==(const Input& other) const
+{
+  return bot == other.bot && h == other.h && v == other.v && actions == other.actions &&
+         instrument == other.instrument && container == other.container;
+}
+
+int Replay::drawSeed()
+{
+  int seed = Math::rand(0, INT_MAX);
+
+  matrix.random.seed(seed);
+  return seed;
+}
+
+void Replay::beginRecording(const Stream& state)
+{
+  stream = Stream(0, Endian::LITTLE);
+  stream.writeInt(state.tell());
+  stream.write(state.begin(), state.tell());
+
+  lastInput   = Input();
+  input       = Input();
+  isRecording = true;
+}
+
+void Replay::recordInput(const Bot* bot)
+{
+  if (!isRecording) {
+    return;
+  }
+
+  if (bot == nullptr) {
+    input = Input();
+  }
+  else {
+    input.bot        = bot->index;
+    input.h          = bot->h;
+    input.v          = bot->v;
+    input.actions    = bot->actions;
+    input.instrument = bot->instrument;
+    input.container  = bot->container;
+  }
+}
+
+void Replay::seedMatrix()
+{
+  if (isRecording) {
+    matrixSeed = drawSeed();
+  }
+}
+
+void Replay::seedNirvana()
+{
+  if (isRecording) {
+    nirvanaSeed = drawSeed();
+  }
+}
+
+void Replay::endTick()
+{
+  if (!isRecording) {
+    return;
+  }
+
+  flags = 0;
+
+  if (!(input == lastInput)) {
+    flags    |= INPUT_BIT;
+    lastInput = input;
+  }
+  if (timer.nTicks % HASH_INTERVAL == 0) {
+    flags |= HASH_BIT;
+    hash   = matrix.hash();
+  }
+
+  stream.writeUByte(ubyte(flags));
+  stream.writeInt(matrixSeed);
+  stream.writeInt(nirvanaSeed);
+  stream.writeInt(nMindUpdates);
+
+  if (flags & INPUT_BIT) {
+    stream.writeInt16(int16(input.bot));
+    stream.writeFloat(input.h);
+    stream.writeFloat(input.v);
+    stream.writeInt(input.actions);
+    stream.writeInt(input.instrument);
+    stream.writeInt(input.container);
+  }
+  if (flags & HASH_BIT) {
+    stream.writeUInt64(hash);
+  }
+}
+
+bool Replay::endRecording(const File& file)
+{
+  if (!isRecording) {
+    return false;
+  }
+
+  stream.writeUByte(END_BIT);
+
+  bool isWritten = file.write(stream.compress());
+
+  stream      = Stream();
+  isRecording = false;
+  return isWritten;
+}
+
+bool Replay::beginReplay(const File& file, Stream* state)
+{
+  if (!file.read(&stream)) {
+    return false;
+  }
+
+  stream = stream.decompress();
+  if (stream.available() < int(sizeof(int))) {
+    return false;
+  }
+
+  int size = stream.readInt();
+  if (size < 0 || stream.available() < size) {
+    return false;
+  }
+
+  *state = Stream(size, stream.order());
+  state->write(stream.readSkip(size), size);
+  state->rewind();
+
+  input = Input();
+  return true;
+}
+
+bool Replay::readTick()
+{
+  if (stream.available() == 0) {
+    return false;
+  }
+
+  flags = stream.readUByte();
+  if (flags & END_BIT) {
+    stream = Stream();
+    return false;
+  }
+
+  matrixSeed   = stream.readInt();
+  nirvanaSeed  = stream.readInt();
+  nMindUpdates = stream.readInt();
+
+  if (flags & INPUT_BIT) {
+    input.bot        = stream.readInt16();
+    input.h          = stream.readFloat();
+    input.v          = stream.readFloat();
+    input.actions    = stream.readInt();
+    input.instrument = stream.readInt();
+    input.container  = stream.readInt();
+  }
+  if (flags & HASH_BIT) {
+    hash = stream.readUInt64();
+  }
+  return true;
+}
+
+void Replay::applyInput() const
+{
+  Bot* bot = orbis.obj<Bot>(input.bot);
+
+  if (bot != nullptr && (bot->flags & Object::BOT_BIT)) {
+    bot->h          = input.h;
+    bot->v          = input.v;
+    bot->actions    = input.actions;
+    bot->instrument = input.instrument;
+    bot->container  = input.container;
+  }
+}
+
+Replay replay;
+
+}
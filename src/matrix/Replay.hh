@@ -0,0 +1,147 @@
+/*
+ * OpenZone - simple cross-platform FPS/RTS game engine.
+ *
+ * Copyright © 2002-2019 Davorin Učakar
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file matrix/Replay.hh
+ *
+ * Recording of game sessions for exact re-simulation.
+ */
+
+#pragma once
+
+#include <matrix/Bot.hh>
+
+namespace oz
+{
+
+/**
+ * Session recording that can be re-simulated tick by tick.
+ *
+ * All randomness of a tick comes from two seeds, one set before the world update and one before
+ * minds are updated. How many minds are updated depends on their time budget, so the number is
+ * recorded too. With player input, the seeds and the number of minds recorded, a simulation from
+ * the same initial state should follow the recorded one exactly. World hashes recorded at
+ * intervals verify that.
+ *
+ * Replay layout, compressed as a whole: size of the initial state and the state itself (as the
+ * caller wrote it), then a record per tick terminated by `END_BIT`. A record consists of flags
+ * (ubyte), seeds for world and minds update (int each), number of minds updated (int), player
+ * input if `INPUT_BIT` is set and world hash (uint64) if `HASH_BIT` is set. Input is only recorded
+ * when it changes.
+ */
+class Replay
+{
+public:
+
+  // Ticks between recorded world hashes.
+  static constexpr int HASH_INTERVAL = int(Timer::TICKS_PER_SEC);
+
+  // record flags
+  static constexpr int INPUT_BIT = 0x01;
+  static constexpr int HASH_BIT  = 0x02;
+  static constexpr int END_BIT   = 0x80;
+
+  /**
+   * Player's bot and its controls as set before the world update.
+   */
+  struct Input
+  {
+    int   bot        = -1;
+    float h          = 0.0f;
+    float v          = 0.0f;
+    int   actions    = 0;
+    int   instrument = -1;
+    int   container  = -1;
+
+    bool operator==(const Input& other) const;
+  };
+
+private:
+
+  Stream stream;
+  Input  lastInput;
+
+public:
+
+  bool   isRecording  = false;
+
+  // Current tick.
+  Input  input;
+  int    flags        = 0;
+  int    matrixSeed   = 0;
+  int    nirvanaSeed  = 0;
+  int    nMindUpdates = 0;
+  uint64 hash         = 0;
+
+private:
+
+  static int drawSeed();
+
+public:
+
+  /**
+   * Start recording from a given initial state.
+   */
+  void beginRecording(const Stream& state);
+
+  /**
+   * Record input of the player's bot, nullptr if there is none.
+   */
+  void recordInput(const Bot* bot);
+
+  /**
+   * Seed the simulation's generator, `Matrix::random`, before the world update.
+   */
+  void seedMatrix();
+
+  /**
+   * Seed the simulation's generator, `Matrix::random`, before the minds update.
+   */
+  void seedNirvana();
+
+  /**
+   * Record the tick, world must be in its final state for the tick.
+   */
+  void endTick();
+
+  /**
+   * Stop recording and write the replay.
+   */
+  bool endRecording(const File& file);
+
+  /**
+   * Open a replay and read its initial state.
+   */
+  bool beginReplay(const File& file, Stream* state);
+
+  /**
+   * Read record of the next tick, false at the end of the replay.
+   */
+  bool readTick();
+
+  /**
+   * Apply recorded input to the player's bot.
+   */
+  void applyInput() const;
+
+};
+
+extern Replay replay;
+
+}
@@ -0,0 +1,254 @@
+/*
+ * OpenZone - simple cross-platform FPS/RTS game engine.
+ *
+ * Copyright © 2002-2019 Davorin Učakar
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <matrix/Replicator.hh>
+
+#include <matrix/Liber.hh>
+#include <matrix/Synapse.hh>
+
+namespace oz
+{
+
+void Replicator::send(int index, Baseline& base, uint64 tick)
+{
+  if (base.sentTick == 0) {
+    pendingIndices.add(index);
+  }
+  base.sentTick = tick;
+}
+
+void Replicator::write(Stream* os)
+{
+  uint64 tick = timer.nTicks;
+
+  nAdded   = 0;
+  nUpdated = 0;
+  nRemoved = 0;
+
+  os->writeUInt64(tick);
+
+  for (int index : synapse.removedObjects) {
+    Baseline& base = baselines[index];
+
+    if (base.ackedSize != -1 || base.sentTick != 0) {
+      base.sentSize = -1;
+      send(index, base, tick);
+    }
+  }
+  for (int index : synapse.addedObjects) {
+    Baseline& base = baselines[index];
+
+    base.isReplaced = base.ackedSize != -1 || base.sentTick != 0;
+  }
+
+  for (const List<int>* indices : {&orbis.objectIndices(), &orbis.sleepingIndices()}) {
+    for (int index : *indices) {
+      const Object* obj = orbis.obj(index);
+
+      if (obj == nullptr) {
+        continue;
+      }
+
+      Baseline& base = baselines[index];
+
+      updateStream.rewind();
+      obj->writeUpdate(&updateStream);
+
+      int  size    = updateStream.tell();
+      bool isKnown = base.ackedSize != -1 && !base.isReplaced;
+
+      OZ_ASSERT(size <= MAX_UPDATE_SIZE);
+
+      // A different state may be in flight, so unchanged objects are only skipped when there is
+      // none.
+      if (isKnown && base.sentTick == 0 && size == base.ackedSize &&
+          memcmp(updateStream.begin(), base.acked, size_t(size)) == 0)
+      {
+        continue;
+      }
+
+      os->writeInt16(int16(index));
+
+      if (isKnown) {
+        os->writeUByte(0);
+
+        ++nUpdated;
+      }
+      else {
+        os->writeUByte(ADDED_BIT);
+        os->writeString(obj->clazz->name);
+
+        ++nAdded;
+      }
+
+      os->writeUByte(ubyte(size));
+      os->write(updateStream.begin(), size);
+
+      memcpy(base.sent, updateStream.begin(), size_t(size));
+      base.sentSize = size;
+      send(index, base, tick);
+    }
+  }
+
+  // Removals are repeated until acknowledged, unless the index has been reused meanwhile.
+  for (int index : pendingIndices) {
+    Baseline& base = baselines[index];
+
+    if (base.sentSize == -1) {
+      os->writeInt16(int16(index));
+      os->writeUByte(REMOVED_BIT);
+
+      base.sentTick = tick;
+      ++nRemoved;
+    }
+  }
+
+  os->writeInt16(-1);
+}
+
+void Replicator::acknowledge(uint64 tick)
+{
+  for (int i = 0; i < pendingIndices.size();) {
+    int       index = pendingIndices[i];
+    Baseline& base  = baselines[index];
+
+    if (base.sentTick <= tick) {
+      memcpy(base.acked, base.sent, size_t(max(base.sentSize, 0)));
+      base.ackedSize  = base.sentSize;
+      base.sentTick   = 0;
+      base.isReplaced = false;
+
+      pendingIndices.eraseUnordered(i);
+    }
+    else {
+      ++i;
+    }
+  }
+}
+
+bool Replicator::isValid(Stream* is) const
+{
+  if (is->available() < int(sizeof(uint64))) {
+    return false;
+  }
+  is->readUInt64();
+
+  while (is->available() >= int(sizeof(int16))) {
+    int index = is->readInt16();
+
+    if (index == -1) {
+      return true;
+    }
+    if (uint(index) >= uint(replicas.size()) || is->available() < 1) {
+      return false;
+    }
+
+    int recordFlags = is->readUByte();
+
+    if (recordFlags & REMOVED_BIT) {
+      continue;
+    }
+    if (recordFlags & ADDED_BIT) {
+      const char* name = is->pos();
+
+      if (memchr(name, '\0', size_t(is->available())) == nullptr || !liber.hasObjClass(name)) {
+        return false;
+      }
+      is->readString();
+    }
+
+    if (is->available() < 1) {
+      return false;
+    }
+
+    int size = is->readUByte();
+
+    if (size > MAX_UPDATE_SIZE || is->available() < size) {
+      return false;
+    }
+    is->readSkip(size);
+  }
+  return false;
+}
+
+uint64 Replicator::read(Stream* is)
+{
+  int begin = is->tell();
+
+  if (!isValid(is)) {
+    return lastTick;
+  }
+  is->seek(begin);
+
+  uint64 tick = is->readUInt64();
+
+  if (tick <= lastTick) {
+    return lastTick;
+  }
+
+  for (int index = is->readInt16(); index != -1; index = is->readInt16()) {
+    Replica& replica     = replicas[index];
+    int      recordFlags = is->readUByte();
+
+    if (recordFlags & REMOVED_BIT) {
+      replica.clazz = nullptr;
+      replica.size  = -1;
+      continue;
+    }
+    if (recordFlags & ADDED_BIT) {
+      replica.clazz = liber.objClass(is->readString());
+    }
+
+    replica.size = is->readUByte();
+    memcpy(replica.data, is->readSkip(replica.size), size_t(replica.size));
+  }
+
+  lastTick = tick;
+  return tick;
+}
+
+void Replicator::load()
+{
+  baselines.resize(Orbis::MAX_OBJECTS, true);
+  replicas.resize(Orbis::MAX_OBJECTS, true);
+  pendingIndices.reserve(256);
+
+  updateStream = Stream(MAX_UPDATE_SIZE);
+  lastTick     = 0;
+
+  nAdded   = 0;
+  nUpdated = 0;
+  nRemoved = 0;
+}
+
+void Replicator::unload()
+{
+  baselines.clear();
+  baselines.trim();
+  replicas.clear();
+  replicas.trim();
+  pendingIndices.clear();
+  pendingIndices.trim();
+
+  updateStream = Stream();
+}
+
+Replicator replicator;
+
+}
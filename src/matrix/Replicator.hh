@@ -0,0 +1,137 @@
+/*
+ * OpenZone - simple cross-platform FPS/RTS game engine.
+ *
+ * Copyright © 2002-2019 Davorin Učakar
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file matrix/Replicator.hh
+ *
+ * World snapshot encoding for replication to clients.
+ */
+
+#pragma once
+
+#include <matrix/Orbis.hh>
+
+namespace oz
+{
+
+/**
+ * Per-tick world snapshots for clients.
+ *
+ * An object's replicated state is its `Object::writeUpdate()` output. A snapshot only contains
+ * objects whose state differs from the last one the receiver has acknowledged, objects the
+ * receiver doesn't know yet and objects removed since. Changes are repeated in every snapshot
+ * until acknowledged, so snapshots may be lost. Receiver drops snapshots older than the last one
+ * it has read.
+ *
+ * Snapshot layout: tick (uint64), then records terminated by index -1. A record is the object
+ * index (int16) and record flags (ubyte), followed by class name if `ADDED_BIT` is set and by the
+ * update size (ubyte) and bytes unless `REMOVED_BIT` is set.
+ */
+class Replicator
+{
+public:
+
+  static constexpr int MAX_UPDATE_SIZE = 64;
+
+  // record flags
+  static constexpr int ADDED_BIT   = 0x01;
+  static constexpr int REMOVED_BIT = 0x02;
+
+  /**
+   * Object as known by the receiver.
+   */
+  struct Replica
+  {
+    const ObjectClass* clazz = nullptr;
+    int                size  = -1;
+    char               data[MAX_UPDATE_SIZE];
+  };
+
+private:
+
+  struct Baseline
+  {
+    uint64 sentTick   = 0;     // tick of the last snapshot with this object, 0 if acknowledged
+    int    ackedSize  = -1;    // -1 if the receiver has no object at this index
+    int    sentSize   = -1;    // -1 if the last record sent was a removal
+    bool   isReplaced = false; // index has been reused since acknowledged
+    char   acked[MAX_UPDATE_SIZE];
+    char   sent[MAX_UPDATE_SIZE];
+  };
+
+  List<Baseline> baselines;
+  List<int>      pendingIndices;
+  Stream         updateStream;
+
+  List<Replica>  replicas;
+  uint64         lastTick = 0;
+
+public:
+
+  // statistics for the last snapshot written
+  int nAdded;
+  int nUpdated;
+  int nRemoved;
+
+private:
+
+  void send(int index, Baseline& base, uint64 tick);
+  bool isValid(Stream* is) const;
+
+public:
+
+  /**
+   * Write snapshot for the current tick.
+   *
+   * Must be called once per tick after `matrix.update()` and before `synapse.update()` so that
+   * `Synapse` lists of added and removed objects are still valid.
+   */
+  void write(Stream* os);
+
+  /**
+   * Receiver has read all snapshots up to and including the one for a given tick.
+   */
+  void acknowledge(uint64 tick);
+
+  /**
+   * Read snapshot into replicas and return the tick to acknowledge.
+   *
+   * Snapshot is rejected as a whole if it is truncated, refers to an index out of range or an
+   * unknown class or has an oversized update. Replicas are left intact and the last tick read is
+   * returned, as for a stale snapshot.
+   */
+  uint64 read(Stream* is);
+
+  /**
+   * Receiver's view of the object at a given index.
+   */
+  OZ_ALWAYS_INLINE
+  const Replica& replica(int index) const
+  {
+    return replicas[index];
+  }
+
+  void load();
+  void unload();
+
+};
+
+extern Replicator replicator;
+
+}
@@ -62,6 +62,7 @@ const Entity::Handler Entity::HANDLERS[] = {
 
 List<Object*> Struct::overlappingObjs;
 Pool<Struct>  Struct::pool;
+uint64        Struct::nObjectRemovals = 0;
 
 bool Entity::trigger()
 {
@@ -73,6 +74,7 @@ bool Entity::trigger()
     OZ_ASSERT(time == 0.0f);
 
     state = OPENING;
+    orbis.str(str->index)->wake(this);
   }
 
   int strIndex = clazz->target >> Struct::MAX_ENT_SHIFT;
@@ -87,6 +89,10 @@ bool Entity::trigger()
 
   target.state = target.state == OPEN || target.state == OPENING ? CLOSING : OPENING;
   target.time  = 0.0f;
+  targetStr->wake(&target);
+
+  orbis.touch(str);
+  orbis.touch(targetStr);
 
   return true;
 }
@@ -99,6 +105,7 @@ bool Entity::lock(Bot* user)
 
   if (user->clazz->key == key || user->clazz->key == ~key) {
     key = ~key;
+    orbis.touch(str);
     return true;
   }
 
@@ -107,12 +114,40 @@ bool Entity::lock(Bot* user)
 
     if (obj->clazz->key == key || obj->clazz->key == ~key) {
       key = ~key;
+      orbis.touch(str);
       return true;
     }
   }
   return false;
 }
 
+bool Entity::isActive() const
+{
+  switch (clazz->type) {
+    case EntityClass::DOOR: {
+      return state == OPENING || state == CLOSING ||
+             (state == OPEN && clazz->closeTimeout != 0.0f);
+    }
+    case EntityClass::MOVER: {
+      return state == OPENING || state == CLOSING;
+    }
+    default: {
+      return state != CLOSED;
+    }
+  }
+}
+
+void Entity::onTrigger()
+{
+  if (state == CLOSED && collider.overlaps(this, clazz->margin)) {
+    state = OPENING;
+    time  = 0.0f;
+
+    orbis.str(str->index)->wake(this);
+    orbis.touch(str);
+  }
+}
+
 void Entity::staticHandler()
 {
   state = CLOSED;
@@ -162,14 +197,7 @@ void Entity::doorHandler()
 
   switch (state) {
     case CLOSED: {
-      if (clazz->flags & EntityClass::AUTO_OPEN) {
-        bool checkTick = (timer.nTicks + uint(str->index * 1025)) % (Timer::TICKS_PER_SEC / 6) == 0;
-
-        if (checkTick && collider.overlaps(this, clazz->margin)) {
-          state = OPENING;
-          time  = 0.0f;
-        }
-      }
+      // Auto-open doors are opened through their trigger volumes by `onTrigger()`.
       break;
     }
     case OPENING: {
@@ -256,6 +284,7 @@ void Struct::onDemolish()
     else if (dyn->flags & Object::DYNAMIC_BIT) {
       dyn->flags &= ~Object::DISABLED_BIT;
       dyn->flags |= Object::ENABLE_BIT;
+      dyn->wake();
     }
   }
 
@@ -275,14 +304,29 @@ void Struct::onDemolish()
   maxs = bb.maxs;
 }
 
-void Struct::onUpdate()
+void Struct::scheduleEntities()
 {
-  for (int i = 0; i < boundObjects.size();) {
-    if (orbis.obj(boundObjects[i]) == nullptr) {
-      boundObjects.eraseUnordered(i);
+  for (int i = 0; i < entities.size(); ++i) {
+    if (entities[i].isActive()) {
+      activeEntities.add(i);
     }
-    else {
-      ++i;
+  }
+}
+
+void Struct::onUpdate()
+{
+  orbis.touch(this);
+
+  if (nPrunedRemovals != nObjectRemovals) {
+    nPrunedRemovals = nObjectRemovals;
+
+    for (int i = 0; i < boundObjects.size();) {
+      if (orbis.obj(boundObjects[i]) == nullptr) {
+        boundObjects.eraseUnordered(i);
+      }
+      else {
+        ++i;
+      }
     }
   }
 
@@ -290,8 +334,17 @@ void Struct::onUpdate()
     onDemolish();
   }
   else {
-    for (Entity& entity : entities) {
+    for (int i = 0; i < activeEntities.size();) {
+      Entity& entity = entities[activeEntities[i]];
+
       (entity.*Entity::HANDLERS[entity.clazz->type])();
+
+      if (entity.isActive()) {
+        ++i;
+      }
+      else {
+        activeEntities.erase(i);
+      }
     }
   }
 }
@@ -340,8 +393,22 @@ Bounds Struct::toAbsoluteCS(const Bounds& bb) const
   }
 }
 
+void Struct::wake(const Entity* entity)
+{
+  int i = int(entity - entities.begin());
+
+  OZ_ASSERT(uint(i) < uint(entities.size()));
+
+  if (entity->isActive() && !activeEntities.contains(i)) {
+    activeEntities.add(i);
+  }
+}
+
 void Struct::destroy()
 {
+  orbis.touch(this);
+  orbis.removeTriggers(this);
+
   for (int i : boundObjects) {
     Object* obj = orbis.obj(i);
 
@@ -402,6 +469,9 @@ Struct::Struct(const BSP* bsp_, int index_, const Point& p_, Heading heading_)
   if (bsp->nBoundObjects != 0) {
     boundObjects.reserve(bsp->nBoundObjects, true);
   }
+
+  nPrunedRemovals = nObjectRemovals;
+  scheduleEntities();
 }
 
 Struct::Struct(const BSP* bsp_, int index_, const Json& json)
@@ -447,6 +517,9 @@ Struct::Struct(const BSP* bsp_, int index_, const Json& json)
   if (bsp->nBoundObjects != 0) {
     boundObjects.reserve(bsp->nBoundObjects, true);
   }
+
+  nPrunedRemovals = nObjectRemovals;
+  scheduleEntities();
 }
 
 Struct::Struct(const BSP* bsp_, Stream* is)
@@ -496,6 +569,9 @@ Struct::Struct(const BSP* bsp_, Stream* is)
       boundObjects.add(is->readInt());
     }
   }
+
+  nPrunedRemovals = nObjectRemovals;
+  scheduleEntities();
 }
 
 Json Struct::write() const
@@ -72,6 +72,16 @@ public:
   bool trigger();
   bool lock(Bot* user);
 
+  /**
+   * Whether the handler has anything to do: entity is moving or waiting for a timeout.
+   */
+  bool isActive() const;
+
+  /**
+   * An object has entered entity's trigger volume, open if it's an auto-open door.
+   */
+  void onTrigger();
+
 private:
 
   void staticHandler();
@@ -98,6 +108,9 @@ public:
   static List<Object*> overlappingObjs;
   static Pool<Struct>  pool;
 
+  // Number of objects removed from the world, so bound objects are only pruned when necessary.
+  static uint64        nObjectRemovals;
+
 private:
 
   Mat4         transf;
@@ -121,6 +134,13 @@ public:
 
 private:
 
+  // Indices of entities whose handlers are run on update.
+  List<int>    activeEntities;
+  uint64       nPrunedRemovals;
+
+private:
+
+  void scheduleEntities();
   void onDemolish();
   void onUpdate();
 
@@ -188,6 +208,13 @@ public:
 
   void destroy();
 
+  /**
+   * Run entity's handler on updates until it becomes inactive.
+   *
+   * Must be called after entity's state has been changed from outside of its handler.
+   */
+  void wake(const Entity* entity);
+
   OZ_ALWAYS_INLINE
   void damage(float damage)
   {
@@ -201,7 +228,9 @@ public:
   OZ_ALWAYS_INLINE
   void update()
   {
-    if (!entities.isEmpty() || !boundObjects.isEmpty() || life == 0.0f) {
+    if (!activeEntities.isEmpty() || life == 0.0f ||
+        (!boundObjects.isEmpty() && nPrunedRemovals != nObjectRemovals))
+    {
       onUpdate();
     }
   }
@@ -22,6 +22,7 @@
 #include <matrix/Liber.hh>
 #include <matrix/Collider.hh>
 #include <matrix/Bot.hh>
+#include <matrix/Matrix.hh>
 
 namespace oz
 {
@@ -53,6 +54,9 @@ bool Synapse::transferItem(Object* source, Dynamic* item, Object* target)
   target->items.add(item->index);
   source->items.exclude(item->index);
 
+  orbis.touch(source);
+  orbis.touch(target);
+
   if (source->flags & Object::BOT_BIT) {
     Bot* bot = static_cast<Bot*>(source);
 
@@ -72,6 +76,7 @@ bool Synapse::takeItem(Object* container, Dynamic* item)
 
   item->parent = container->index;
   container->items.add(item->index);
+  orbis.touch(container);
   cut(item);
 
   return true;
@@ -89,6 +94,7 @@ bool Synapse::dropItem(Object* container, Dynamic* item, const Point& p, const V
 
   item->parent = -1;
   container->items.exclude(item->index);
+  orbis.touch(container);
   put(item);
 
   if (container->flags & Object::BOT_BIT) {
@@ -176,7 +182,7 @@ Object* Synapse::add(const ObjectClass* clazz, const Point& p, Heading heading,
 
   if (!empty) {
     for (const ObjectClass* defaultItem : obj->clazz->defaultItems) {
-      Heading itemHeading = Heading(Math::rand(NORTH, EAST));
+      Heading itemHeading = Heading(matrix.random.rand(NORTH, EAST));
       Dynamic* item = static_cast<Dynamic*>(orbis.add(defaultItem, Point::ORIGIN, itemHeading));
 
       if (item == nullptr) {
@@ -219,20 +225,20 @@ void Synapse::gen(const FragPool* pool, int nFrags, const Bounds& bb, const Vec3
 {
   for (int i = 0; i < nFrags; ++i) {
     // spawn the frag somewhere in the upper half of the structure's bounding box
-    Point fragPos = Point(Math::rand(bb.mins.x, bb.maxs.x),
-                          Math::rand(bb.mins.y, bb.mins.y),
-                          Math::rand(bb.mins.z, bb.mins.z));
+    Point fragPos = Point(matrix.random.rand(bb.mins.x, bb.maxs.x),
+                          matrix.random.rand(bb.mins.y, bb.mins.y),
+                          matrix.random.rand(bb.mins.z, bb.mins.z));
 
     Frag*  frag = add(pool, fragPos, velocity);
     if (frag == nullptr) {
       continue;
     }
 
-    frag->velocity += Vec3(Math::normalRand(0.0f, pool->velocitySpread),
-                           Math::normalRand(0.0f, pool->velocitySpread),
-                           Math::normalRand(0.0f, pool->velocitySpread));
+    frag->velocity += Vec3(matrix.random.normalRand(0.0f, pool->velocitySpread),
+                           matrix.random.normalRand(0.0f, pool->velocitySpread),
+                           matrix.random.normalRand(0.0f, pool->velocitySpread));
 
-    frag->life     += Math::normalRand(0.0f, pool->lifeSpread);
+    frag->life     += matrix.random.normalRand(0.0f, pool->lifeSpread);
   }
 }
 
@@ -277,6 +283,7 @@ void Synapse::remove(Struct* str)
     if (obj->flags & Object::DYNAMIC_BIT) {
       obj->flags &= ~Object::DISABLED_BIT;
       obj->flags |= Object::ENABLE_BIT;
+      obj->wake();
     }
   }
 
@@ -306,6 +313,7 @@ void Synapse::remove(Object* obj)
       if (sObj->flags & Object::DYNAMIC_BIT) {
         sObj->flags &= ~Object::DISABLED_BIT;
         sObj->flags |= Object::ENABLE_BIT;
+        sObj->wake();
       }
     }
 
@@ -34,12 +34,10 @@ void Terra::load(int id_)
   id = id_;
 
   if (id == -1) {
-    for (auto& column : quads) {
-      for (Quad& quad : column) {
-        quad.vertex.z   = 0.0f;
-        quad.normals[0] = Vec3(0.0f, 0.0f, 1.0f);
-        quad.normals[1] = Vec3(0.0f, 0.0f, 1.0f);
-      }
+    for (Quad& quad : quads) {
+      quad.vertex.z   = 0.0f;
+      quad.normals[0] = Vec3(0.0f, 0.0f, 1.0f);
+      quad.normals[1] = Vec3(0.0f, 0.0f, 1.0f);
     }
   }
   else {
@@ -54,18 +52,27 @@ void Terra::load(int id_)
     }
 
     int max = is.readInt();
-    if (max != VERTS) {
-      OZ_ERROR("Invalid dimension %d, should be %d", max, VERTS);
+    if (max != MAX_VERTS) {
+      OZ_ERROR("Invalid dimension %d, should be %d", max, MAX_VERTS);
     }
 
-    for (auto& column : quads) {
-      for (Quad& quad : column) {
-        quad.vertex.z = is.readFloat();
+    for (int x = 0; x < MAX_VERTS; ++x) {
+      if (uint(x - offset) > uint(nQuads)) {
+        is.readSkip(MAX_VERTS * int(sizeof(float)));
+        continue;
+      }
+
+      for (int y = 0; y < MAX_VERTS; ++y) {
+        float height = is.readFloat();
+
+        if (uint(y - offset) <= uint(nQuads)) {
+          quads[x - offset][y - offset].vertex.z = height;
+        }
       }
     }
 
-    for (int x = 0; x < QUADS; ++x) {
-      for (int y = 0; y < QUADS; ++y) {
+    for (int x = 0; x < nQuads; ++x) {
+      for (int y = 0; y < nQuads; ++y) {
         const Point& a = quads[x    ][y    ].vertex;
         const Point& b = quads[x + 1][y    ].vertex;
         const Point& c = quads[x + 1][y + 1].vertex;
@@ -82,14 +89,22 @@ void Terra::load(int id_)
   }
 }
 
-void Terra::init()
+void Terra::resize(int size)
 {
-  for (int x = 0; x < VERTS; ++x) {
-    for (int y = 0; y < VERTS; ++y) {
-      quads[x][y].vertex.x = float(x * Quad::SIZE - DIM);
-      quads[x][y].vertex.y = float(y * Quad::SIZE - DIM);
+  nQuads = size / Quad::SIZE;
+  dim    = size / 2;
+  offset = (MAX_QUADS - nQuads) / 2;
+
+  quads.resize(nQuads + 1);
+
+  for (int x = 0; x <= nQuads; ++x) {
+    for (int y = 0; y <= nQuads; ++y) {
+      quads[x][y].vertex.x = float(x * Quad::SIZE - dim);
+      quads[x][y].vertex.y = float(y * Quad::SIZE - dim);
     }
   }
+
+  load(id);
 }
 
 void Terra::read(const Json& json)
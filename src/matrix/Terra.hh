@@ -58,32 +58,36 @@ public:
     Vec3  normals[2];                 ///< [0] upper-left and [1] lower-right triangle normal.
   };
 
-  // Orbis::DIM == Terrain::DIM == Terrain::MAX * TerraQuad::DIM
-  static constexpr int QUADS = 2 * MAX_WORLD_COORD / Quad::SIZE;
-  static constexpr int VERTS = QUADS + 1;
-  static constexpr int DIM   = QUADS * Quad::DIM;
-
-  Quad quads[VERTS][VERTS]; ///< Vertices and triangle normals.
-  int  liquid;              ///< Either `matrix::Medium::GLOBAL_WATER_BIT` or
-                            ///< `matrix::Medium::GLOBAL_LAVA_BIT`.
-  int  id;
+  // Terrain files cover the largest world, smaller worlds only keep its central part.
+  // Orbis::MAX_DIM == Terra::MAX_DIM == Terra::MAX_QUADS * Terra::Quad::DIM
+  static constexpr int MAX_QUADS = 2 * MAX_WORLD_COORD / Quad::SIZE;
+  static constexpr int MAX_VERTS = MAX_QUADS + 1;
+  static constexpr int MAX_DIM   = MAX_QUADS * Quad::DIM;
+
+  Grid<Quad> quads;      ///< Vertices and triangle normals, `nQuads + 1` on each axis.
+  int        nQuads = 0; ///< Number of quads on x and y axes, they cover the world.
+  int        dim    = 0; ///< Half of the terrain length, the same as world's.
+  int        offset = 0; ///< Index of the first kept vertex in the terrain file on each axis.
+  int        liquid;     ///< Either `matrix::Medium::GLOBAL_WATER_BIT` or
+                         ///< `matrix::Medium::GLOBAL_LAVA_BIT`.
+  int        id     = -1;
 
   Span getInters(float minX, float minY, float maxX, float maxY, float epsilon = 0.0f) const
   {
     return {
-      max(int((minX - epsilon + DIM) / Quad::SIZE), 0),
-      max(int((minY - epsilon + DIM) / Quad::SIZE), 0),
-      min(int((maxX + epsilon + DIM) / Quad::SIZE), QUADS - 1),
-      min(int((maxY + epsilon + DIM) / Quad::SIZE), QUADS - 1)
+      max(int((minX - epsilon + float(dim)) / Quad::SIZE), 0),
+      max(int((minY - epsilon + float(dim)) / Quad::SIZE), 0),
+      min(int((maxX + epsilon + float(dim)) / Quad::SIZE), nQuads - 1),
+      min(int((maxY + epsilon + float(dim)) / Quad::SIZE), nQuads - 1)
     };
   }
 
   Pos2 getIndices(float x, float y) const
   {
-    int ix = int((x + DIM) / Quad::SIZE);
-    int iy = int((y + DIM) / Quad::SIZE);
+    int ix = int((x + float(dim)) / Quad::SIZE);
+    int iy = int((y + float(dim)) / Quad::SIZE);
 
-    return {clamp(ix, 0, QUADS - 1), clamp(iy, 0, QUADS - 1)};
+    return {clamp(ix, 0, nQuads - 1), clamp(iy, 0, nQuads - 1)};
   }
 
   float getHeight(float x, float y) const
@@ -102,7 +106,11 @@ public:
 
   void reset();
   void load(int id_);
-  void init();
+
+  /**
+   * Resize terrain to cover a world of a given size and reload its heights.
+   */
+  void resize(int size);
 
   void read(const Json& json);
   void read(Stream* is);
@@ -437,13 +437,14 @@ void Vehicle::onUpdate()
           nRounds[weapon] = max(-1, nRounds[weapon] - 1);
 
           addEvent(EVENT_SHOT0 + weapon, 1.0f);
-          luaMatrix.objectCall(clazz->onWeaponShot[weapon], this, bot);
+          luaMatrix.objectCall(clazz->onWeaponShotIndices[weapon], this, bot);
         }
       }
     }
   }
 
   p = oldPos;
+  orbis.resort(this);
 
   for (int i = 0; i < clazz->nWeapons; ++i) {
     if (shotTime[i] > 0.0f) {
@@ -632,10 +633,51 @@ void Vehicle::write(Stream* os) const
   }
 }
 
-void Vehicle::readUpdate(Stream*)
-{}
+void Vehicle::readUpdate(Stream* is)
+{
+  const VehicleClass* clazz = static_cast<const VehicleClass*>(this->clazz);
 
-void Vehicle::writeUpdate(Stream*) const
-{}
+  Dynamic::readUpdate(is);
+
+  h          = unpackAngle(is->readUInt16());
+  v          = unpackAngle(is->readUInt16());
+  w          = unpackAngle(is->readUInt16());
+  oldActions = actions;
+  actions    = is->readInt();
+
+  rot        = clazz->type == VehicleClass::MECH ? Mat4::rotationZ(h) : Mat4::rotationZXZ(h, v, w);
+  oldState   = state;
+  state      = is->readInt();
+  fuel       = unpackRatio(is->readUByte()) * clazz->fuel;
+
+  pilot      = is->readInt16();
+
+  weapon     = is->readByte();
+  for (int i = 0; i < MAX_WEAPONS; ++i) {
+    nRounds[i] = is->readInt16();
+  }
+}
+
+void Vehicle::writeUpdate(Stream* os) const
+{
+  const VehicleClass* clazz = static_cast<const VehicleClass*>(this->clazz);
+
+  Dynamic::writeUpdate(os);
+
+  os->writeUInt16(packAngle(h));
+  os->writeUInt16(packAngle(v));
+  os->writeUInt16(packAngle(w));
+  os->writeInt(actions);
+
+  os->writeInt(state);
+  os->writeUByte(packRatio(fuel / clazz->fuel));
+
+  os->writeInt16(int16(pilot));
+
+  os->writeByte(byte(weapon));
+  for (int i = 0; i < MAX_WEAPONS; ++i) {
+    os->writeInt16(int16(nRounds[i]));
+  }
+}
 
 }
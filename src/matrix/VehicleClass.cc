@@ -153,6 +153,7 @@ void VehicleClass::init(const Json& config, const char* name_)
   for (int i = 0; i < VehicleClass::MAX_WEAPONS; ++i) {
     weaponTitles[i]        = "";
     onWeaponShot[i]        = "";
+    onWeaponShotIndices[i] = -1;
     nWeaponRounds[i]       = 0;
     weaponShotIntervals[i] = 0.0f;
   }
@@ -160,6 +161,7 @@ void VehicleClass::init(const Json& config, const char* name_)
   for (int i = 0; i < nWeapons; ++i) {
     weaponTitles[i]        = lingua.get(weaponsConfig[i]["title"].get(""));
     onWeaponShot[i]        = weaponsConfig[i]["onShot"].get("");
+    onWeaponShotIndices[i] = liber.addLuaFunction(onWeaponShot[i]);
     nWeaponRounds[i]       = weaponsConfig[i]["nRounds"].get(-1);
     weaponShotIntervals[i] = weaponsConfig[i]["shotInterval"].get(0.5f);
 
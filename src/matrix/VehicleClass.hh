@@ -117,6 +117,7 @@ public:
   int    nWeapons;
   String weaponTitles[MAX_WEAPONS];
   String onWeaponShot[MAX_WEAPONS];
+  int    onWeaponShotIndices[MAX_WEAPONS];
   int    nWeaponRounds[MAX_WEAPONS];
   float  weaponShotIntervals[MAX_WEAPONS];
 
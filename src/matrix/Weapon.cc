@@ -53,6 +53,7 @@ bool Weapon::onUse(Bot* user)
 
       parent = user->index;
       container->items.exclude(index);
+      orbis.touch(container);
     }
     return true;
   }
@@ -66,7 +67,7 @@ void Weapon::onUpdate()
   }
 
   if ((flags & LUA_BIT) && !clazz->onUpdate.isEmpty()) {
-    luaMatrix.objectCall(clazz->onUpdate, this);
+    luaMatrix.objectCall(clazz->onUpdateIndex, this);
   }
 
   if (!(flags & Object::UPDATE_FUNC_BIT)) {
@@ -93,7 +94,7 @@ void Weapon::trigger(Bot* user)
 
     shotTime = clazz->shotInterval;
 
-    if (nRounds != 0 && luaMatrix.objectCall(clazz->onShot, this, user)) {
+    if (nRounds != 0 && luaMatrix.objectCall(clazz->onShotIndex, this, user)) {
       nRounds = max(-1, nRounds - 1);
       success = true;
     }
@@ -139,10 +140,18 @@ void Weapon::write(Stream* os) const
   os->writeFloat(shotTime);
 }
 
-void Weapon::readUpdate(Stream*)
-{}
+void Weapon::readUpdate(Stream* is)
+{
+  Dynamic::readUpdate(is);
+
+  nRounds = is->readInt16();
+}
 
-void Weapon::writeUpdate(Stream*) const
-{}
+void Weapon::writeUpdate(Stream* os) const
+{
+  Dynamic::writeUpdate(os);
+
+  os->writeInt16(int16(nRounds));
+}
 
 }
@@ -58,6 +58,7 @@ void WeaponClass::init(const Json& config, const char* name_)
   shotInterval = config["shotInterval"].get(0.5f);
 
   onShot       = config["onShot"].get("");
+  onShotIndex  = liber.addLuaFunction(onShot);
 
   if (!onShot.isEmpty()) {
     flags |= Object::LUA_BIT;
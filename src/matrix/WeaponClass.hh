@@ -38,6 +38,7 @@ public:
   float  shotInterval;
 
   String onShot;
+  int    onShotIndex;
 
 public:
 
@@ -25,6 +25,7 @@ namespace oz
 {
 
 void importMatrixConstants(lua_State* l);
+void updateMatrixConstants(lua_State* l);
 
 void importMatrixConstants(lua_State* l)
 {
@@ -42,7 +43,6 @@ void importMatrixConstants(lua_State* l)
   };
 
   registerLuaConstant(l, "OZ_EPSILON",                     EPSILON);
-  registerLuaConstant(l, "OZ_ORBIS_DIM",                   Orbis::DIM);
 
   registerLuaConstant(l, "OZ_NORTH",                       NORTH);
   registerLuaConstant(l, "OZ_WEST",                        WEST);
@@ -189,6 +189,13 @@ void importMatrixConstants(lua_State* l)
   registerLuaConstant(l, "OZ_ACTION_INV_GIVE",             Bot::ACTION_INV_GIVE);
   registerLuaConstant(l, "OZ_ACTION_INV_DROP",             Bot::ACTION_INV_DROP);
   registerLuaConstant(l, "OZ_ACTION_INV_GRAB",             Bot::ACTION_INV_GRAB);
+
+  updateMatrixConstants(l);
+}
+
+void updateMatrixConstants(lua_State* l)
+{
+  registerLuaConstant(l, "OZ_ORBIS_DIM", orbis.size / 2);
 }
 
 }
@@ -34,6 +34,16 @@
 namespace oz
 {
 
+/**
+ * Register matrix-specific Lua constants with a given Lua VM.
+ */
+void importMatrixConstants(lua_State* l);
+
+/**
+ * Update Lua constants that follow the loaded world (`OZ_ORBIS_DIM`) in a given Lua VM.
+ */
+void updateMatrixConstants(lua_State* l);
+
 enum AddMode
 {
   ADD_FORCE = 0,
@@ -64,9 +74,12 @@ struct MatrixLuaState
 
   List<Struct*> structs;
   List<Object*> objects;
+
+  Random        random;
 };
 
-static MatrixLuaState ms;
+// Per thread, so minds can run on several Lua states in parallel.
+static thread_local MatrixLuaState ms;
 
 #ifdef __clang__
 # pragma clang diagnostic push
@@ -76,6 +89,51 @@ static MatrixLuaState ms;
 /// @addtogroup luaapi
 /// @{
 
+/*
+ * Math
+ */
+
+/**
+ * Replacement for `math.random()` drawing from the state's own generator.
+ *
+ * @code float|int math.random([int m [, int n]]) @endcode
+ *
+ * Same as Lua's, a float from `[0, 1)` without arguments, an integer from `[1, m]` or `[m, n]`
+ * otherwise. Unlike Lua's, the sequence is reseeded on every simulation step.
+ */
+static int ozMathRandom(lua_State* l)
+{
+  VARG(0, 2)
+
+  if (l_gettop() == 0) {
+    l_pushfloat(ms.random.rand(0.0f, 1.0f));
+    return 1;
+  }
+
+  int min = l_gettop() == 1 ? 1 : l_toint(1);
+  int max = l_toint(l_gettop());
+
+  if (max < min) {
+    ERROR("Interval is empty");
+  }
+
+  l_pushint(ms.random.rand(min, max + 1));
+  return 1;
+}
+
+/**
+ * Replacement for `math.randomseed()` seeding the state's own generator.
+ *
+ * @code void math.randomseed(int seed) @endcode
+ */
+static int ozMathRandomseed(lua_State* l)
+{
+  ARG(1)
+
+  ms.random.seed(l_toint(1));
+  return 0;
+}
+
 /*
  * Orbis
  */
@@ -84,10 +142,25 @@ static int ozOrbisGetSize(lua_State* l)
 {
   ARG(0)
 
-  l_pushint(2 * Orbis::DIM);
+  l_pushint(orbis.size);
   return 1;
 }
 
+static int ozOrbisResize(lua_State* l)
+{
+  VARG(1, 2)
+
+  int size     = l_toint(1);
+  int cellSize = l_gettop() == 2 ? l_toint(2) : Orbis::DEFAULT_CELL_SIZE;
+
+  if (!orbis.resize(size, cellSize)) {
+    ERROR("World and cell size must be powers of two within limits and the world must be empty");
+  }
+
+  updateMatrixConstants(l);
+  return 0;
+}
+
 static int ozOrbisGetDim(lua_State* l)
 {
   ARG(0)
@@ -124,7 +197,7 @@ static int ozOrbisAddStr(lua_State* l)
 
   AddMode mode    = AddMode(l_toint(1));
   Point   p       = Point(l_tofloat(3), l_tofloat(4), l_tofloat(5));
-  Heading heading = Heading(Math::rand(NORTH, EAST));
+  Heading heading = Heading(ms.random.rand(NORTH, EAST));
   bool    empty   = false;
 
   int nParams = l_gettop();
@@ -160,7 +233,7 @@ static int ozOrbisAddObj(lua_State* l)
 
   AddMode mode    = AddMode(l_toint(1));
   Point   p       = Point(l_tofloat(3), l_tofloat(4), l_tofloat(5));
-  Heading heading = Heading(Math::rand(NORTH, EAST));
+  Heading heading = Heading(ms.random.rand(NORTH, EAST));
   bool    empty   = false;
 
   int nParams = l_gettop();
@@ -537,6 +610,7 @@ static int ozStrSetLife(lua_State* l)
   STR()
 
   ms.str->life = clamp(l_tofloat(1), 0.0f, ms.str->bsp->life);
+  orbis.touch(ms.str);
   return 0;
 }
 
@@ -546,6 +620,7 @@ static int ozStrAddLife(lua_State* l)
   STR()
 
   ms.str->life = clamp(ms.str->life + l_tofloat(1), 0.0f, ms.str->bsp->life);
+  orbis.touch(ms.str);
   return 0;
 }
 
@@ -573,6 +648,7 @@ static int ozStrSetResistance(lua_State* l)
   STR()
 
   ms.str->resistance = max(0.0f, l_tofloat(1));
+  orbis.touch(ms.str);
   return 0;
 }
 
@@ -582,6 +658,7 @@ static int ozStrDamage(lua_State* l)
   STR()
 
   ms.str->damage(l_tofloat(1));
+  orbis.touch(ms.str);
   return 0;
 }
 
@@ -591,6 +668,7 @@ static int ozStrDestroy(lua_State* l)
   STR()
 
   ms.str->destroy();
+  orbis.touch(ms.str);
   return 0;
 }
 
@@ -892,6 +970,7 @@ static int ozEntSetLock(lua_State* l)
   ENT()
 
   ms.ent->key = l_toint(1);
+  orbis.touch(ms.ent->str);
   return 0;
 }
 
@@ -1273,7 +1352,14 @@ static int ozObjWarpPos(lua_State* l)
   ms.obj->p.y = l_tofloat(2);
   ms.obj->p.z = l_tofloat(3);
 
+  // Keep cell membership and sorted broadphase lists in step with the new position.
+  if (ms.obj->cell != nullptr) {
+    orbis.reposition(ms.obj);
+  }
+
   ms.obj->flags &= ~Object::MOVE_CLEAR_MASK;
+  ms.obj->wake();
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1338,6 +1424,7 @@ static int ozObjSetLife(lua_State* l)
   OBJ()
 
   ms.obj->life = clamp(l_tofloat(1), 0.0f, ms.obj->clazz->life);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1347,6 +1434,7 @@ static int ozObjAddLife(lua_State* l)
   OBJ()
 
   ms.obj->life = clamp(ms.obj->life + l_tofloat(1), 0.0f, ms.obj->clazz->life);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1374,6 +1462,7 @@ static int ozObjSetResistance(lua_State* l)
   OBJ()
 
   ms.obj->resistance = max(0.0f, l_tofloat(1));
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1386,6 +1475,7 @@ static int ozObjAddEvent(lua_State* l)
   float intensity = l_tofloat(2);
 
   ms.obj->addEvent(id, intensity);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1400,6 +1490,7 @@ static int ozObjEnableUpdate(lua_State* l)
   else {
     ms.obj->flags &= ~Object::UPDATE_FUNC_BIT;
   }
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1426,6 +1517,7 @@ static int ozObjDamage(lua_State* l)
   OBJ()
 
   ms.obj->damage(l_tofloat(1));
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1447,6 +1539,7 @@ static int ozObjDestroy(lua_State* l)
   if (l_tobool(1)) {
     ms.obj->flags |= Object::DESTROYED_BIT;
   }
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1511,7 +1604,9 @@ static int ozObjAddItem(lua_State* l)
   else {
     const char* sClazz = l_tostring(1);
 
-    Object* obj = synapse.addObject(sClazz, Point::ORIGIN, Heading(Math::rand(NORTH, EAST)), false);
+    Heading heading = Heading(ms.random.rand(NORTH, EAST));
+
+    Object* obj = synapse.addObject(sClazz, Point::ORIGIN, heading, false);
     if (obj == nullptr) {
       l_pushbool(false);
       return 1;
@@ -1532,6 +1627,7 @@ static int ozObjAddItem(lua_State* l)
   }
 
   l_pushbool(true);
+  orbis.touch(ms.obj);
   return 1;
 }
 
@@ -1546,6 +1642,7 @@ static int ozObjRemoveItem(lua_State* l)
   }
 
   synapse.removeObject(ms.obj->items[item]);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1558,6 +1655,7 @@ static int ozObjRemoveAllItems(lua_State* l)
     synapse.removeObject(item);
   }
   ms.obj->items.clear();
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1824,9 +1922,11 @@ static int ozDynSetMomentum(lua_State* l)
   OBJ_DYNAMIC()
 
   dyn->flags     &= ~Object::DISABLED_BIT;
+  dyn->wake();
   dyn->momentum.x = l_tofloat(1);
   dyn->momentum.y = l_tofloat(2);
   dyn->momentum.z = l_tofloat(3);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1837,9 +1937,11 @@ static int ozDynAddMomentum(lua_State* l)
   OBJ_DYNAMIC()
 
   dyn->flags      &= ~Object::DISABLED_BIT;
+  dyn->wake();
   dyn->momentum.x += l_tofloat(1);
   dyn->momentum.y += l_tofloat(2);
   dyn->momentum.z += l_tofloat(3);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1898,6 +2000,7 @@ static int ozWeaponSetRounds(lua_State* l)
   const WeaponClass* weaponClazz = static_cast<const WeaponClass*>(weapon->clazz);
 
   weapon->nRounds = clamp(l_toint(1), -1, weaponClazz->nRounds);
+  orbis.touch(ms.obj);
   return 1;
 }
 
@@ -1912,6 +2015,7 @@ static int ozWeaponAddRounds(lua_State* l)
   if (weapon->nRounds != -1) {
     weapon->nRounds = min(weapon->nRounds + l_toint(1), weaponClazz->nRounds);
   }
+  orbis.touch(ms.obj);
   return 1;
 }
 
@@ -1936,6 +2040,7 @@ static int ozBotSetName(lua_State* l)
   OBJ_BOT()
 
   bot->name = l_tostring(1);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1955,7 +2060,9 @@ static int ozBotSetMind(lua_State* l)
   OBJ()
   OBJ_BOT()
 
-  bot->mind = l_tostring(1);
+  bot->mind      = l_tostring(1);
+  bot->mindIndex = liber.luaFunctionIndex(bot->mind);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -1999,6 +2106,7 @@ static int ozBotSetH(lua_State* l)
 
   bot->h = Math::rad(l_tofloat(1));
   bot->h = angleWrap(bot->h);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2010,6 +2118,7 @@ static int ozBotAddH(lua_State* l)
 
   bot->h += Math::rad(l_tofloat(1));
   bot->h  = angleWrap(bot->h);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2031,6 +2140,7 @@ static int ozBotSetV(lua_State* l)
 
   bot->v = Math::rad(l_tofloat(1));
   bot->v = clamp(bot->v, 0.0f, Math::TAU / 2.0f);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2042,6 +2152,7 @@ static int ozBotAddV(lua_State* l)
 
   bot->v += Math::rad(l_tofloat(1));
   bot->v  = clamp(bot->v, 0.0f, Math::TAU / 2.0f);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2098,6 +2209,7 @@ static int ozBotSetStamina(lua_State* l)
   const BotClass* clazz = static_cast<const BotClass*>(bot->clazz);
 
   bot->stamina = clamp(l_tofloat(1), 0.0f, clazz->stamina);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2110,6 +2222,7 @@ static int ozBotAddStamina(lua_State* l)
   const BotClass* clazz = static_cast<const BotClass*>(bot->clazz);
 
   bot->stamina = clamp(bot->stamina + l_tofloat(1), 0.0f, clazz->stamina);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2174,6 +2287,7 @@ static int ozBotSetWeaponItem(lua_State* l)
   }
 
   l_pushbool(true);
+  orbis.touch(ms.obj);
   return 1;
 }
 
@@ -2219,6 +2333,7 @@ static int ozBotAction(lua_State* l)
   else {
     bot->actions |= action;
   }
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2229,6 +2344,7 @@ static int ozBotClearActions(lua_State* l)
   OBJ_BOT()
 
   bot->actions = 0;
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2239,6 +2355,7 @@ static int ozBotHeal(lua_State* l)
   OBJ_BOT()
 
   bot->heal();
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2249,6 +2366,7 @@ static int ozBotRearm(lua_State* l)
   OBJ_BOT()
 
   bot->rearm();
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2259,6 +2377,7 @@ static int ozBotKill(lua_State* l)
   OBJ_BOT()
 
   bot->kill();
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2298,6 +2417,7 @@ static int ozVehicleSetH(lua_State* l)
   veh->h = angleWrap(veh->h);
 
   veh->rot = Mat4::rotationZXZ(veh->h, veh->v - Math::TAU / 4.0f, 0.0f);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2311,6 +2431,7 @@ static int ozVehicleAddH(lua_State* l)
   veh->h  = angleWrap(veh->h);
 
   veh->rot = Mat4::rotationZXZ(veh->h, veh->v - Math::TAU / 4.0f, 0.0f);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2334,6 +2455,7 @@ static int ozVehicleSetV(lua_State* l)
   veh->v = clamp(veh->v, 0.0f, Math::TAU / 2.0f);
 
   veh->rot = Mat4::rotationZXZ(veh->h, veh->v - Math::TAU / 4.0f, 0.0f);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2347,6 +2469,7 @@ static int ozVehicleAddV(lua_State* l)
   veh->v  = clamp(veh->v, 0.0f, Math::TAU / 2.0f);
 
   veh->rot = Mat4::rotationZXZ(veh->h, veh->v - Math::TAU / 4.0f, 0.0f);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2390,6 +2513,7 @@ static int ozVehicleEmbarkBot(lua_State* l)
 
   veh->pilot = bot->index;
   bot->enter(veh->index);
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2405,6 +2529,7 @@ static int ozVehicleDisembarkBot(lua_State* l)
   }
 
   pilot->exit();
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2415,6 +2540,7 @@ static int ozVehicleService(lua_State* l)
   OBJ_VEHICLE()
 
   veh->service();
+  orbis.touch(ms.obj);
   return 0;
 }
 
@@ -2766,9 +2892,5 @@ static int ozFragIsVisibleFromSelfEye(lua_State* l)
 # pragma clang diagnostic pop
 #endif
 
-/**
- * Register matrix-specific Lua constants with a given Lua VM.
- */
-void importMatrixConstants(lua_State* l);
 
 }
@@ -24,15 +24,8 @@
 namespace oz
 {
 
-namespace
-{
-
-// For IMPORT_FUNC()/IGNORE_FUNC() macros.
-LuaNirvana& lua = luaNirvana;
-
-}
-
-void LuaNirvana::mindCall(const char* functionName, Mind* mind, Bot* self)
+void LuaNirvana::mindCall(int function, const char* functionName, Mind* mind, Bot* self,
+                          int seed)
 {
   lua_State* l = l_;
 
@@ -47,10 +40,13 @@ void LuaNirvana::mindCall(const char* functionName, Mind* mind, Bot* self)
   ns.mind     = mind;
   ns.device   = nullptr;
 
-  l_getglobal(functionName);
+  ms.random.seed(seed);
+  updateMatrixConstants(l);
+
+  pushFunction(function, functionName);
   l_rawgeti(1, self->index);
 
-  if (l_pcall(1, 0) != LUA_OK) {
+  if (pcall(functionName, 1, 0) != LUA_OK) {
     Log::println("Lua[N] in %s(self = %d): %s", functionName, self->index, l_tostring(-1));
     System::bell();
 
@@ -80,26 +76,17 @@ void LuaNirvana::unregisterMind(int botIndex)
   l_rawseti(1, botIndex);
 }
 
-void LuaNirvana::read(Stream* is)
+void LuaNirvana::readMind(int botIndex, Stream* is)
 {
   lua_State* l = l_;
 
   OZ_ASSERT(l_gettop() == 1);
-  OZ_ASSERT((l_pushnil(), true));
-  OZ_ASSERT(!l_next(1));
-
-  int index = is->readInt();
-
-  while (index != -1) {
-    readValue(l_, is);
 
-    l_rawseti(1, index);
-
-    index = is->readInt();
-  }
+  readValue(l_, is);
+  l_rawseti(1, botIndex);
 }
 
-void LuaNirvana::write(Stream* os)
+void LuaNirvana::writeMinds(Stream* os)
 {
   lua_State* l = l_;
 
@@ -115,8 +102,6 @@ void LuaNirvana::write(Stream* os)
 
     l_pop(1);
   }
-
-  os->writeInt(-1);
 }
 
 void LuaNirvana::init()
@@ -126,6 +111,9 @@ void LuaNirvana::init()
   Lua::init("tsm");
   lua_State* l = l_;
 
+  // For IMPORT_FUNC()/IGNORE_FUNC() macros.
+  LuaNirvana& lua = *this;
+
   ls.envName = "nirvana";
   ms.structs.reserve(32);
   ms.objects.reserve(512);
@@ -139,12 +127,20 @@ void LuaNirvana::init()
 
   IMPORT_FUNC(ozForceUpdate);
 
+  /*
+   * Math
+   */
+
+  lua["math"]["random"]     = ozMathRandom;
+  lua["math"]["randomseed"] = ozMathRandomseed;
+
   /*
    * Orbis
    */
 
   IMPORT_FUNC(ozOrbisGetSize);
   IMPORT_FUNC(ozOrbisGetDim);
+  IGNORE_FUNC(ozOrbisResize);
 
   IMPORT_FUNC(ozOrbisGetGravity);
   IGNORE_FUNC(ozOrbisSetGravity);
@@ -481,6 +477,7 @@ void LuaNirvana::init()
 
   IMPORT_FUNC(ozSelfOverlaps);
   IMPORT_FUNC(ozSelfBindOverlaps);
+  IMPORT_FUNC(ozSelfObjsVisibleFromEye);
 
   /*
    * Mind
@@ -522,6 +519,8 @@ void LuaNirvana::init()
   loadDir("@lua/common");
   loadDir("@lua/nirvana");
 
+  bindFunctions(liber.luaFunctions);
+
   OZ_ASSERT(l_gettop() == 1);
 
   Log::printEnd(" OK");
@@ -34,13 +34,22 @@ class LuaNirvana : public Lua
 {
 public:
 
-  void mindCall(const char* functionName, Mind* mind, Bot* self);
+  // Function is given by its index in `Liber::luaFunctions`, by name if -1. `math.random()` is
+  // reseeded with `seed` and world constants are refreshed before the call.
+  void mindCall(int function, const char* functionName, Mind* mind, Bot* self, int seed);
 
   void registerMind(int botIndex);
   void unregisterMind(int botIndex);
 
-  void read(Stream* is);
-  void write(Stream* os);
+  /**
+   * Read local data of a mind.
+   */
+  void readMind(int botIndex, Stream* is);
+
+  /**
+   * Write local data of all minds registered with this state, each prefixed by its bot index.
+   */
+  void writeMinds(Stream* os);
 
   void init();
   void destroy();
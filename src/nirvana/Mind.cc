@@ -19,6 +19,7 @@
 
 #include <nirvana/Mind.hh>
 
+#include <nirvana/Nirvana.hh>
 #include <nirvana/LuaNirvana.hh>
 #include <matrix/Bot.hh>
 
@@ -36,9 +37,9 @@ bool Mind::hasCollided(const Bot* botObj)
 }
 
 Mind::Mind(int bot_)
-  : bot(bot_)
+  : bot(bot_), age(bot_ % BASE_INTERVAL)
 {
-  luaNirvana.registerMind(bot);
+  nirvana.mindLua(bot)->registerMind(bot);
 }
 
 Mind::Mind(int bot_, Stream* is)
@@ -46,39 +47,95 @@ Mind::Mind(int bot_, Stream* is)
 {
   flags = is->readInt();
   side  = is->readInt();
+  age   = is->readInt();
 }
 
 Mind::~Mind()
 {
   if (bot != -1) {
-    luaNirvana.unregisterMind(bot);
+    nirvana.mindLua(bot)->unregisterMind(bot);
   }
 }
 
-void Mind::update(bool doRegularUpdate)
+float Mind::priority(const List<Point>& observers) const
 {
-  Bot* botObj = orbis.obj<Bot>(bot);
+  const Bot* botObj = orbis.obj<const Bot>(bot);
 
   OZ_ASSERT(botObj != nullptr && (botObj->flags & Object::BOT_BIT));
 
   if ((flags & PLAYER_BIT) || (botObj->state & Bot::DEAD_BIT) || botObj->mind.isEmpty()) {
-    return;
+    return -1.0f;
   }
 
-  if (doRegularUpdate || (flags & FORCE_UPDATE_BIT) ||
-      ((flags & COLLISION_UPDATE_BIT) && hasCollided(botObj)))
-  {
-    flags &= ~FORCE_UPDATE_BIT;
-    botObj->actions = 0;
+  bool isHit = hasCollided(botObj);
+
+  if ((flags & FORCE_UPDATE_BIT) || ((flags & COLLISION_UPDATE_BIT) && isHit)) {
+    return Math::INF;
+  }
 
-    luaNirvana.mindCall(botObj->mind, this, botObj);
+  // Without observers (e.g. on a headless server) there is nothing to scale the detail for.
+  if (observers.isEmpty()) {
+    return age < BASE_INTERVAL ? -1.0f : float(age) / float(BASE_INTERVAL);
   }
+
+  float observerDist2 = Math::INF;
+  for (const Point& observer : observers) {
+    observerDist2 = min(observerDist2, (botObj->p - observer).sqN());
+  }
+
+  int   lod      = 0;
+  float lodDist2 = LOD_DISTANCE * LOD_DISTANCE;
+
+  while (lod < MAX_LOD && observerDist2 >= lodDist2) {
+    ++lod;
+    lodDist2 *= 4.0f;
+  }
+
+  if (isHit || (botObj->state & Bot::ATTACKING_BIT)) {
+    lod = max(lod - 1, 0);
+  }
+  else if (!(botObj->state & Bot::MOVING_BIT)) {
+    lod = min(lod + 1, MAX_LOD);
+  }
+
+  int interval = BASE_INTERVAL << lod;
+  return age < interval ? -1.0f : float(age) / float(interval);
+}
+
+void Mind::update(LuaNirvana* lua, int seed)
+{
+  Bot* botObj = orbis.obj<Bot>(bot);
+
+  flags &= ~FORCE_UPDATE_BIT;
+  age    = 0;
+
+  controls.h          = botObj->h;
+  controls.v          = botObj->v;
+  controls.actions    = 0;
+  controls.instrument = botObj->instrument;
+  controls.container  = botObj->container;
+  controls.weapon     = botObj->weapon;
+
+  lua->mindCall(botObj->mindIndex, botObj->mind, this, botObj, seed);
+}
+
+void Mind::apply() const
+{
+  Bot* botObj = orbis.obj<Bot>(bot);
+
+  botObj->h          = controls.h;
+  botObj->v          = controls.v;
+  botObj->actions    = controls.actions;
+  botObj->instrument = controls.instrument;
+  botObj->container  = controls.container;
+  botObj->weapon     = controls.weapon;
 }
 
 void Mind::write(Stream* os) const
 {
   os->writeInt(flags);
   os->writeInt(side);
+  os->writeInt(age);
 }
 
 }
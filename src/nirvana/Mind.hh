@@ -29,13 +29,19 @@ namespace oz
 {
 
 class Bot;
+class LuaNirvana;
 
 class Mind
 {
 public:
 
-  // Normally, mind is only updated once in UPDATE_INTERVAL ticks.
-  static constexpr int UPDATE_INTERVAL = 32;
+  // Update interval in ticks at the highest level of detail, doubled at each lower level. Same as
+  // the fixed interval minds had before levels of detail, so they can only make minds cheaper.
+  static constexpr int   BASE_INTERVAL = 32;
+  // Lowest level of detail, for distant bots. Without observers all minds stay at the highest.
+  static constexpr int   MAX_LOD       = 3;
+  // Level of detail drops at this distance from the nearest observer and at each doubling of it.
+  static constexpr float LOD_DISTANCE  = 32.0f;
   // Force mind update in the next tick. Cleared after update.
   static constexpr int FORCE_UPDATE_BIT = 0x01;
   // Force mind update when a collision occurs (in physical world).
@@ -43,12 +49,31 @@ public:
   // Disabled because player is currently controlling the bot.
   static constexpr int PLAYER_BIT = 0x04;
 
-  Mind* prev[1];
-  Mind* next[1];
-
-  int   flags = 0;
-  int   side  = 0;
-  int   bot   = -1;
+  /**
+   * Bot's controls as set by the mind.
+   *
+   * Minds write controls instead of their bots, controls are applied after all minds have been
+   * updated. So minds only see the world as it was before the update and can be updated in
+   * parallel.
+   */
+  struct Controls
+  {
+    float h          = 0.0f;
+    float v          = 0.0f;
+    int   actions    = 0;
+    int   instrument = -1;
+    int   container  = -1;
+    int   weapon     = -1;
+  };
+
+  Mind*    prev[1];
+  Mind*    next[1];
+
+  int      flags = 0;
+  int      side  = 0;
+  int      bot   = -1;
+  int      age   = 0; // ticks since the last update, new minds are staggered by bot index
+  Controls controls;
 
   static bool hasCollided(const Bot* botObj);
 
@@ -63,7 +88,27 @@ public:
   OZ_NO_COPY(Mind)
   OZ_GENERIC_MOVE(Mind)
 
-  void update(bool doRegularUpdate);
+  /**
+   * Update priority, -1 if the mind is not due in this tick.
+   *
+   * Update interval depends on the level of detail, which is lower for bots far from the nearest
+   * of given observers and for idle bots and higher for bots in combat. If there are no observers,
+   * the interval is `BASE_INTERVAL`. Priority is the number of intervals since the last update or
+   * infinity for forced updates.
+   */
+  float priority(const List<Point>& observers) const;
+
+  /**
+   * Run the mind's Lua function on a given Lua state, which must hold its local data.
+   *
+   * @param seed seed for `math.random()` during the call.
+   */
+  void update(LuaNirvana* lua, int seed);
+
+  /**
+   * Apply controls to the bot.
+   */
+  void apply() const;
 
   void write(Stream* os) const;
 
@@ -19,6 +19,7 @@
 
 #include <nirvana/Nirvana.hh>
 
+#include <matrix/Matrix.hh>
 #include <matrix/Synapse.hh>
 #include <matrix/Bot.hh>
 #include <nirvana/LuaNirvana.hh>
@@ -32,6 +33,41 @@
 namespace oz
 {
 
+void* Nirvana::workerMain(void* data)
+{
+  nirvana.workerRun(static_cast<Worker*>(data));
+  return nullptr;
+}
+
+void Nirvana::workerRun(Worker* worker)
+{
+  int id = int(worker - workers);
+
+  worker->semaphore.wait();
+
+  while (areWorkersAlive.load<RELAXED>()) {
+    updateMinds(id);
+
+    workerSemaphore.post();
+    worker->semaphore.wait();
+  }
+}
+
+void Nirvana::updateMinds(int id)
+{
+  Worker&         worker       = workers[id];
+  Instant<STEADY> beginInstant = Instant<STEADY>::now();
+
+  for (Mind* mind : dueMinds) {
+    if (mind->bot % nWorkers == id) {
+      mind->update(worker.lua, randomSeed ^ mind->bot);
+    }
+  }
+
+  worker.duration = Instant<STEADY>::now() - beginInstant;
+  worker.lua->stepGarbage();
+}
+
 void Nirvana::sync()
 {
   // remove devices and minds of removed objects
@@ -59,24 +95,105 @@ void Nirvana::sync()
 
 void Nirvana::update()
 {
-  int count = 0;
+  for (const auto& i : minds) {
+    if (i.value.flags & Mind::PLAYER_BIT) {
+      const Object* botObj = orbis.obj(i.key);
+
+      if (botObj != nullptr) {
+        observers.add(botObj->p);
+      }
+    }
+  }
 
   for (auto& i : minds) {
-    Mind& mind = i.value;
+    Mind& mind     = i.value;
+    float priority = mind.priority(observers);
+
+    if (priority >= 0.0f) {
+      dueQueue.push(DueMind{priority, &mind});
+    }
+    ++mind.age;
+  }
+  observers.clear();
+
+  int maxUpdates = updateLimit >= 0         ? updateLimit     :
+                   budget == Duration::ZERO ? dueQueue.size() : max(int(budget / mindCost), 1);
+
+  while (!dueQueue.isEmpty() && dueMinds.size() < maxUpdates) {
+    dueMinds.add(dueQueue.pop().mind);
+  }
+  dueQueue.clear();
+
+  nUpdated    = dueMinds.size();
+  updateLimit = -1;
+  randomSeed  = matrix.random.rand(0, INT_MAX);
 
-    mind.update(count % Mind::UPDATE_INTERVAL == updateModulo);
-    ++count;
+  Duration duration = Duration::ZERO;
+
+  if (nWorkers > 1 && dueMinds.size() > 1) {
+    for (int i = 1; i < nWorkers; ++i) {
+      workers[i].semaphore.post();
+    }
+
+    updateMinds(0);
+
+    for (int i = 1; i < nWorkers; ++i) {
+      workerSemaphore.wait();
+    }
+    for (int i = 0; i < nWorkers; ++i) {
+      duration = max(duration, workers[i].duration);
+    }
+  }
+  else {
+    for (int i = 0; i < nWorkers; ++i) {
+      updateMinds(i);
+      duration += workers[i].duration;
+    }
   }
-  updateModulo = (updateModulo + 1) % Mind::UPDATE_INTERVAL;
+
+  if (!dueMinds.isEmpty()) {
+    Duration cost = duration / dueMinds.size();
+
+    mindCost = max((7 * mindCost + cost) / 8, 1_us);
+  }
+
+  for (Mind* mind : dueMinds) {
+    mind->apply();
+  }
+  dueMinds.clear();
 
   techGraph.update();
 }
 
+void Nirvana::flushCallStats()
+{
+  for (int i = 0; i < nWorkers; ++i) {
+    workers[i].lua->flushCallStats("Lua[N] ");
+  }
+}
+
+Lua::AllocStats Nirvana::allocStats() const
+{
+  Lua::AllocStats sum;
+
+  for (int i = 0; i < nWorkers; ++i) {
+    Lua::AllocStats stats = workers[i].lua->allocStats();
+
+    sum.nAllocs      += stats.nAllocs;
+    sum.nBytes       += stats.nBytes;
+    sum.nUsedBytes   += stats.nUsedBytes;
+    sum.nPooledBytes += stats.nPooledBytes;
+  }
+  return sum;
+}
+
 void Nirvana::read(Stream* is)
 {
   Log::print("Reading Nirvana ...");
 
-  luaNirvana.read(is);
+  for (int index = is->readInt(); index != -1; index = is->readInt()) {
+    mindLua(index)->readMind(index, is);
+  }
 
   int nDevices = is->readInt();
   int nMinds   = is->readInt();
@@ -107,7 +224,10 @@ void Nirvana::read(Stream* is)
 
 void Nirvana::write(Stream* os) const
 {
-  luaNirvana.write(os);
+  for (int i = 0; i < nWorkers; ++i) {
+    workers[i].lua->writeMinds(os);
+  }
+  os->writeInt(-1);
 
   os->writeInt(devices.size());
   os->writeInt(minds.size());
@@ -155,16 +275,39 @@ void Nirvana::unload()
   Log::printEnd(" OK");
 }
 
-void Nirvana::init()
+void Nirvana::init(int nThreads, Duration budget_)
 {
   Log::println("Initialising Nirvana {");
   Log::indent();
 
   OZ_REGISTER_DEVICE(Memo);
 
-  luaNirvana.init();
+  nWorkers = max(nThreads, 1);
+  workers  = new Worker[nWorkers];
 
-  updateModulo = 0;
+  workers[0].lua = &luaNirvana;
+  workers[0].lua->init();
+
+  if (nWorkers > 1) {
+    areWorkersAlive.store<RELAXED>(true);
+
+    for (int i = 1; i < nWorkers; ++i) {
+      workers[i].lua = new LuaNirvana();
+      workers[i].lua->init();
+      workers[i].thread = Thread("nirvana", workerMain, &workers[i]);
+    }
+
+    Log::println("Parallel minds on %d threads", nWorkers);
+  }
+
+  budget      = budget_;
+  updateLimit = -1;
+  nUpdated    = 0;
+  mindCost    = 50_us;
+
+  if (budget != Duration::ZERO) {
+    Log::println("Minds budget %.2f ms per tick", budget.t() * 1000.0f);
+  }
 
   Log::unindent();
   Log::println("}");
@@ -175,8 +318,33 @@ void Nirvana::destroy()
   Log::println("Destroy Nirvana {");
   Log::indent();
 
+  if (workers != nullptr) {
+    areWorkersAlive.store<RELAXED>(false);
+
+    for (int i = 1; i < nWorkers; ++i) {
+      workers[i].semaphore.post();
+      workers[i].thread.join();
+
+      workers[i].lua->destroy();
+      delete workers[i].lua;
+    }
+
+    delete[] workers;
+    workers = nullptr;
+  }
+  nWorkers = 0;
+
   luaNirvana.destroy();
 
+  dueQueue.clear();
+  dueQueue.trim();
+
+  dueMinds.clear();
+  dueMinds.trim();
+
+  observers.clear();
+  observers.trim();
+
   deviceClasses.clear();
   deviceClasses.trim();
 
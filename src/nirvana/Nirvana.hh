@@ -29,11 +29,64 @@
 namespace oz
 {
 
+class LuaNirvana;
+
 class Nirvana
 {
 private:
 
-  int updateModulo;
+  /**
+   * Mind worker with its own Lua state, the first one runs on the thread calling `update()` and
+   * uses `luaNirvana`.
+   *
+   * Local data of a mind lives in the Lua state of worker `bot % nWorkers`, which always runs it.
+   */
+  struct Worker
+  {
+    Thread      thread;
+    Semaphore   semaphore;
+    LuaNirvana* lua = nullptr;
+    Duration    duration; // time spent on minds in the last update, without GC
+  };
+
+  Worker*      workers         = nullptr;
+  int          nWorkers        = 0;
+  Semaphore    workerSemaphore;
+  Atomic<bool> areWorkersAlive = {false};
+
+  /**
+   * Mind in the update queue, the most overdue one first, ties broken by bot index.
+   */
+  struct DueMind
+  {
+    float priority;
+    Mind* mind;
+
+    OZ_ALWAYS_INLINE
+    bool operator<(const DueMind& other) const
+    {
+      return priority > other.priority ||
+             (priority == other.priority && mind->bot < other.mind->bot);
+    }
+  };
+
+  Heap<DueMind> dueQueue;
+
+  // Minds updated in the current tick, in the order their controls are applied.
+  List<Mind*>   dueMinds;
+
+  // Moving average of wall time per mind update, with all workers running.
+  Duration      mindCost;
+
+  // Drawn from `Matrix::random` each tick, minds' `math.random()` is seeded from it and bot index.
+  int           randomSeed = 0;
+
+private:
+
+  static void* workerMain(void* data);
+
+  void workerRun(Worker* worker);
+  void updateMinds(int id);
 
 public:
 
@@ -42,16 +95,59 @@ public:
   HashMap<int, Device*> devices;
   HashMap<int, Mind>    minds;
 
+  // Positions minds' levels of detail depend on, besides player-controlled bots. Set by the host
+  // before each update and cleared by it.
+  List<Point>           observers;
+
+  // Time minds may take per tick, zero for no limit.
+  Duration              budget      = Duration::ZERO;
+  // Number of minds to update in the next tick regardless of the budget, -1 if not given. Used
+  // to re-simulate a recorded session.
+  int                   updateLimit = -1;
+  // Number of minds updated in the last tick.
+  int                   nUpdated    = 0;
+
+  /**
+   * Lua state holding local data of a given bot's mind.
+   */
+  OZ_ALWAYS_INLINE
+  LuaNirvana* mindLua(int botIndex) const
+  {
+    return workers[botIndex % nWorkers].lua;
+  }
+
   void sync();
+
+  /**
+   * Update due minds, in parallel if there are several workers, then apply their controls.
+   *
+   * Due minds are updated in the order of priority, as many as fit into the time budget, the
+   * rest stay overdue and gain priority for the next tick. Forced updates are no exception.
+   * Workers' Lua GC slices come on top of the budget.
+   *
+   * Minds may only read the world and write controls of their own bots. Changes of quests,
+   * technologies and devices are serialised, but their order is unspecified with several workers.
+   * `math.random()` is reseeded for each mind, so minds' choices don't depend on workers either.
+   */
   void update();
 
+  /**
+   * Add minds' call statistics from all workers' Lua states to `Profiler`.
+   */
+  void flushCallStats();
+
+  /**
+   * Sum of memory statistics of all workers' Lua states.
+   */
+  Lua::AllocStats allocStats() const;
+
   void read(Stream* is);
   void write(Stream* os) const;
 
   void load();
   void unload();
 
-  void init();
+  void init(int nThreads = 1, Duration budget_ = Duration::ZERO);
   void destroy();
 
 };
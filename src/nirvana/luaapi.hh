@@ -37,12 +37,19 @@ namespace oz
 
 struct NirvanaLuaState
 {
-  Bot*    self;
-  Mind*   mind;
-  Device* device;
+  Bot*                self;
+  Mind*               mind;
+  Device*             device;
+
+  List<const Object*> rayObjects;
+  List<Point>         rayTargets;
+  List<Hit>           rayHits;
 };
 
-static NirvanaLuaState ns;
+static thread_local NirvanaLuaState ns;
+
+// Guards quests, technologies and devices that minds on different threads may change.
+static SpinLock nirvanaLock;
 
 #ifdef __clang__
 # pragma clang diagnostic push
@@ -255,7 +262,7 @@ static int ozSelfGetH(lua_State* l)
 {
   ARG(0)
 
-  l_pushfloat(Math::deg(ns.self->h));
+  l_pushfloat(Math::deg(ns.mind->controls.h));
   return 1;
 }
 
@@ -263,8 +270,8 @@ static int ozSelfSetH(lua_State* l)
 {
   ARG(1)
 
-  ns.self->h = Math::rad(l_tofloat(1));
-  ns.self->h = angleWrap(ns.self->h);
+  ns.mind->controls.h = Math::rad(l_tofloat(1));
+  ns.mind->controls.h = angleWrap(ns.mind->controls.h);
   return 1;
 }
 
@@ -272,8 +279,8 @@ static int ozSelfAddH(lua_State* l)
 {
   ARG(1)
 
-  ns.self->h += Math::rad(l_tofloat(1));
-  ns.self->h  = angleWrap(ns.self->h);
+  ns.mind->controls.h += Math::rad(l_tofloat(1));
+  ns.mind->controls.h  = angleWrap(ns.mind->controls.h);
   return 1;
 }
 
@@ -281,7 +288,7 @@ static int ozSelfGetV(lua_State* l)
 {
   ARG(0)
 
-  l_pushfloat(Math::deg(ns.self->v));
+  l_pushfloat(Math::deg(ns.mind->controls.v));
   return 1;
 }
 
@@ -289,8 +296,8 @@ static int ozSelfSetV(lua_State* l)
 {
   ARG(1)
 
-  ns.self->v = Math::rad(l_tofloat(1));
-  ns.self->v = clamp(ns.self->v, 0.0f, Math::TAU / 2.0f);
+  ns.mind->controls.v = Math::rad(l_tofloat(1));
+  ns.mind->controls.v = clamp(ns.mind->controls.v, 0.0f, Math::TAU / 2.0f);
   return 1;
 }
 
@@ -298,8 +305,8 @@ static int ozSelfAddV(lua_State* l)
 {
   ARG(1)
 
-  ns.self->v += Math::rad(l_tofloat(1));
-  ns.self->v  = clamp(ns.self->v, 0.0f, Math::TAU / 2.0f);
+  ns.mind->controls.v += Math::rad(l_tofloat(1));
+  ns.mind->controls.v  = clamp(ns.mind->controls.v, 0.0f, Math::TAU / 2.0f);
   return 1;
 }
 
@@ -310,8 +317,8 @@ static int ozSelfGetDir(lua_State* l)
   // {hsine, hcosine, vsine, vcosine, vsine * hsine, vsine * hcosine}
   float hvsc[6];
 
-  Math::sincos(ns.self->h, &hvsc[0], &hvsc[1]);
-  Math::sincos(ns.self->v, &hvsc[2], &hvsc[3]);
+  Math::sincos(ns.mind->controls.h, &hvsc[0], &hvsc[1]);
+  Math::sincos(ns.mind->controls.v, &hvsc[2], &hvsc[3]);
 
   hvsc[4] = hvsc[2] * hvsc[0];
   hvsc[5] = hvsc[2] * hvsc[1];
@@ -355,9 +362,9 @@ static int ozSelfGetWeaponItem(lua_State* l)
 {
   ARG(0)
 
-  const Object* weapon = orbis.obj(ns.self->weapon);
+  const Object* weapon = orbis.obj(ns.mind->controls.weapon);
 
-  l_pushint(weapon == nullptr ? -1 : ns.self->weapon);
+  l_pushint(weapon == nullptr ? -1 : ns.mind->controls.weapon);
   return 1;
 }
 
@@ -367,7 +374,7 @@ static int ozSelfSetWeaponItem(lua_State* l)
 
   int item = l_toint(1);
   if (item == -1) {
-    ns.self->weapon = -1;
+    ns.mind->controls.weapon = -1;
   }
   else {
     if (uint(item) >= uint(ns.self->items.size())) {
@@ -388,7 +395,7 @@ static int ozSelfSetWeaponItem(lua_State* l)
 
     const WeaponClass* clazz = static_cast<const WeaponClass*>(weapon->clazz);
     if (ns.self->clazz->name.beginsWith(clazz->userBase)) {
-      ns.self->weapon = index;
+      ns.mind->controls.weapon = index;
     }
   }
 
@@ -424,13 +431,13 @@ static int ozSelfAction(lua_State* l)
   int arg2   = l_toint(3);
 
   if (action & Bot::INSTRUMENT_ACTIONS) {
-    ns.self->actions   &= ~Bot::INSTRUMENT_ACTIONS;
-    ns.self->actions   |= action;
-    ns.self->instrument = arg1;
-    ns.self->container  = arg2;
+    ns.mind->controls.actions   &= ~Bot::INSTRUMENT_ACTIONS;
+    ns.mind->controls.actions   |= action;
+    ns.mind->controls.instrument = arg1;
+    ns.mind->controls.container  = arg2;
   }
   else {
-    ns.self->actions |= action;
+    ns.mind->controls.actions |= action;
   }
   return 0;
 }
@@ -439,7 +446,7 @@ static int ozSelfClearActions(lua_State* l)
 {
   ARG(0)
 
-  ns.self->actions = 0;
+  ns.mind->controls.actions = 0;
   return 0;
 }
 
@@ -534,6 +541,55 @@ static int ozSelfBindOverlaps(lua_State* l)
   return 0;
 }
 
+static int ozSelfObjsVisibleFromEye(lua_State* l)
+{
+  ARG(1)
+
+  if (l_type(1) != LUA_TTABLE) {
+    ERROR("Table of object indices expected");
+  }
+
+  Point eye = Point(ns.self->p.x, ns.self->p.y, ns.self->p.z + ns.self->camZ);
+
+  ns.rayObjects.clear();
+  ns.rayTargets.clear();
+
+  for (int i = 1;; ++i) {
+    l_rawgeti(1, i);
+
+    if (l_type(-1) == LUA_TNIL) {
+      l_pop(1);
+      break;
+    }
+
+    int index = l_toint(-1);
+    l_pop(1);
+
+    if (uint(index) >= uint(Orbis::MAX_OBJECTS)) {
+      ERROR("Invalid object index (out of range)");
+    }
+
+    const Object* obj = orbis.obj(index);
+
+    ns.rayObjects.add(obj);
+    ns.rayTargets.add(obj == nullptr ? eye : obj->p);
+  }
+
+  ns.rayHits.resize(ns.rayTargets.size());
+  collider.translate(eye, ns.rayTargets.begin(), ns.rayTargets.size(), ns.rayHits.begin(), ns.self);
+
+  l_newtable();
+
+  for (int i = 0; i < ns.rayObjects.size(); ++i) {
+    const Object* obj = ns.rayObjects[i];
+    const Hit&    hit = ns.rayHits[i];
+
+    l_pushbool(obj != nullptr && (hit.obj == obj || hit.ratio == 1.0f));
+    l_rawseti(-2, i + 1);
+  }
+  return 1;
+}
+
 /*
  * Mind
  */
@@ -562,12 +618,18 @@ static int ozQuestAdd(lua_State* l)
 {
   ARG(6)
 
+  nirvanaLock.lock();
+
   questList.add(l_tostring(1),
                 l_tostring(2),
                 Point(l_tofloat(3), l_tofloat(4), l_tofloat(5)),
                 Quest::State(l_toint(6)));
 
-  l_pushint(questList.quests.size() - 1);
+  int id = questList.quests.size() - 1;
+
+  nirvanaLock.unlock();
+
+  l_pushint(id);
   return 1;
 }
 
@@ -575,12 +637,21 @@ static int ozQuestEnd(lua_State* l)
 {
   ARG(2)
 
-  int id = l_toint(1);
-  if (uint(id) >= uint(questList.quests.size())) {
-    ERROR("Invalid quest id");
+  int  id      = l_toint(1);
+  bool isValid = false;
+
+  nirvanaLock.lock();
+
+  if (uint(id) < uint(questList.quests.size())) {
+    questList.quests[id].state = l_tobool(2) ? Quest::SUCCESSFUL : Quest::FAILED;
+    isValid = true;
   }
 
-  questList.quests[id].state = l_tobool(2) ? Quest::SUCCESSFUL : Quest::FAILED;
+  nirvanaLock.unlock();
+
+  if (!isValid) {
+    ERROR("Invalid quest id");
+  }
   return 0;
 }
 
@@ -594,7 +665,11 @@ static int ozTechEnable(lua_State* l)
 
   const char* technology = l_tostring(1);
 
-  l_pushbool(techGraph.enable(technology));
+  nirvanaLock.lock();
+  bool isEnabled = techGraph.enable(technology);
+  nirvanaLock.unlock();
+
+  l_pushbool(isEnabled);
   return 1;
 }
 
@@ -604,7 +679,11 @@ static int ozTechDisable(lua_State* l)
 
   const char* technology = l_tostring(1);
 
-  l_pushbool(techGraph.disable(technology));
+  nirvanaLock.lock();
+  bool isDisabled = techGraph.disable(technology);
+  nirvanaLock.unlock();
+
+  l_pushbool(isDisabled);
   return 1;
 }
 
@@ -612,7 +691,9 @@ static int ozTechEnableAll(lua_State* l)
 {
   ARG(0)
 
+  nirvanaLock.lock();
   techGraph.enableAll();
+  nirvanaLock.unlock();
   return 0;
 }
 
@@ -620,7 +701,9 @@ static int ozTechDisableAll(lua_State* l)
 {
   ARG(0)
 
+  nirvanaLock.lock();
   techGraph.disableAll();
+  nirvanaLock.unlock();
   return 0;
 }
 
@@ -633,16 +716,20 @@ static int ozNirvanaRemoveDevice(lua_State* l)
   ARG(1)
 
   int index = l_toint(1);
+
+  nirvanaLock.lock();
+
   const Device* const* device = nirvana.devices.find(index);
+  bool                 exists = device != nullptr;
 
-  if (device == nullptr) {
-    l_pushbool(false);
-  }
-  else {
+  if (exists) {
     delete *device;
     nirvana.devices.exclude(index);
-    l_pushbool(true);
   }
+
+  nirvanaLock.unlock();
+
+  l_pushbool(exists);
   return 1;
 }
 
@@ -653,11 +740,20 @@ static int ozNirvanaAddMemo(lua_State* l)
   ARG(2)
   OBJ_INDEX(index)
 
-  if (nirvana.devices.contains(index)) {
-    ERROR("object already has a device");
+  const char* text = l_tostring(2);
+
+  nirvanaLock.lock();
+
+  bool exists = nirvana.devices.contains(index);
+  if (!exists) {
+    nirvana.devices.add(index, new Memo(text));
   }
 
-  nirvana.devices.add(index, new Memo(l_tostring(2)));
+  nirvanaLock.unlock();
+
+  if (exists) {
+    ERROR("object already has a device");
+  }
   return 0;
 }
 
@@ -215,7 +215,8 @@ void Log::printProfilerStatistics()
     indent();
 
     for (const auto& i : range) {
-      println("%.6f s\t %s", double(i.value.ns()) / 1e6, i.key.c());
+      println("%.6f s %10ld x %12ld B\t %s", double(i.value.time.ns()) / 1e9,
+              long(i.value.count), long(i.value.nBytes), i.key.c());
     }
 
     unindent();
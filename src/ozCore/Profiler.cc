@@ -28,31 +28,37 @@ namespace oz
 namespace
 {
 
-HashMap<String, Duration> profileTimes;
+HashMap<String, Profiler::Entry> profileEntries;
 
 }
 
 Profiler::CRange Profiler::crange() noexcept
 {
-  return CRange(profileTimes.cbegin(), profileTimes.cend());
+  return CRange(profileEntries.cbegin(), profileEntries.cend());
 }
 
 void Profiler::add(const char* key, Duration duration)
 {
-  Duration* time = profileTimes.find(key);
+  add(key, duration, 1, 0);
+}
 
-  if (time == nullptr) {
-    profileTimes.add(key, duration);
-  }
-  else {
-    *time += duration;
+void Profiler::add(const char* key, Duration duration, int64 count, int64 nBytes)
+{
+  Entry* entry = profileEntries.find(key);
+
+  if (entry == nullptr) {
+    entry = &profileEntries.add(key, Entry()).value;
   }
+
+  entry->time   += duration;
+  entry->count  += count;
+  entry->nBytes += nBytes;
 }
 
 void Profiler::clear()
 {
-  profileTimes.clear();
-  profileTimes.trim();
+  profileEntries.clear();
+  profileEntries.trim();
 }
 
 }
@@ -53,35 +53,50 @@ namespace oz
 /**
  * Profiling statistics.
  *
- * This class has an internal hashtable of string-microseconds pairs. `add()` function may be used
- * to add a new entry or add time to an existing entry, but `OZ_PROFILER_BEGIN()` and
- * `OZ_PROFILER_END()` macros are probably better suited.
+ * This class has an internal hashtable of accumulated times, counts and allocated bytes per string.
+ * `add()` function may be used to add a new entry or add to an existing entry, but
+ * `OZ_PROFILER_BEGIN()` and `OZ_PROFILER_END()` macros are probably better suited for timing.
  */
 class Profiler
 {
 public:
 
   /**
-   * Constant iterator for accumulated times.
+   * Accumulated statistics for a key.
    */
-  using CRange = HashMap<String, Duration>::CRange;
+  struct Entry
+  {
+    Duration time   = Duration::ZERO; ///< Total time.
+    int64    count  = 0;              ///< Number of times measured (e.g. calls).
+    int64    nBytes = 0;              ///< Bytes allocated, if measured.
+  };
+
+  /**
+   * Constant iterator for accumulated statistics.
+   */
+  using CRange = HashMap<String, Entry>::CRange;
 
 public:
 
   /**
-   * Return constant iterator for accumulated times.
+   * Return constant iterator for accumulated statistics.
    */
   static CRange crange() noexcept;
 
   /**
-   * Add a time to a named sum.
+   * Add a time to a named sum and increment its count.
    *
-   * If the key doesn't exist, a new key with initial value `duration` is added.
+   * If the key doesn't exist, a new key with initial time `duration` is added.
    */
   static void add(const char* key, Duration duration);
 
   /**
-   * Clear internal hashtable, deleting all times.
+   * Add a time, a count and allocated bytes to named sums.
+   */
+  static void add(const char* key, Duration duration, int64 count, int64 nBytes);
+
+  /**
+   * Clear internal hashtable, deleting all statistics.
    */
   static void clear();
 
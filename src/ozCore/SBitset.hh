@@ -230,6 +230,31 @@ public:
     data_[i / UNIT_BITS] ^= uint64(1) << (i % UNIT_BITS);
   }
 
+  /**
+   * Index of the first false bit at position `start` or after it, -1 if there is none.
+   *
+   * Bits are scanned a whole unit at a time, so a nearly full bitset is searched 64 bits per step.
+   */
+  int findFirstZero(int start = 0) const
+  {
+    if (uint(start) >= uint(BITS)) {
+      return -1;
+    }
+
+    int    unit = start / UNIT_BITS;
+    uint64 free = ~data_[unit] & (~uint64(0) << (start % UNIT_BITS));
+
+    while (free == 0) {
+      if (++unit == SIZE) {
+        return -1;
+      }
+      free = ~data_[unit];
+    }
+
+    int index = unit * UNIT_BITS + __builtin_ctzll(free);
+    return index < BITS ? index : -1;
+  }
+
   /**
    * %Set all bits to false.
    */
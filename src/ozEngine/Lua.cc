@@ -22,6 +22,8 @@
 
 #include "Lua.hh"
 
+#include <cstdlib>
+#include <cstring>
 #include <lua.hpp>
 
 #if LUA_VERSION_NUM < 502
@@ -441,7 +443,107 @@ void Lua::Field::setMetatable(const char* name)
   lua_pop(l_, 1);
 }
 
-int Lua::randomSeed = 0;
+struct Lua::Allocator
+{
+  static constexpr int SIZE_STEP   = 16;
+  static constexpr int N_POOLS     = MAX_POOLED_SIZE / SIZE_STEP;
+  static constexpr int BLOCK_BYTES = 4096;
+
+  PoolAlloc  pools[N_POOLS];
+  AllocStats stats;
+
+  Allocator()
+  {
+    for (int i = 0; i < N_POOLS; ++i) {
+      int slotSize = (i + 1) * SIZE_STEP;
+
+      pools[i] = PoolAlloc(slotSize, BLOCK_BYTES / slotSize);
+    }
+  }
+
+  OZ_ALWAYS_INLINE
+  static int poolIndex(size_t size)
+  {
+    return size <= size_t(MAX_POOLED_SIZE) ? int(size - 1) / SIZE_STEP : -1;
+  }
+
+  void* allocate(size_t size)
+  {
+    int index = poolIndex(size);
+
+    if (index < 0) {
+      return malloc(size);
+    }
+
+    PoolAlloc& pool     = pools[index];
+    int        capacity = pool.capacity();
+    void*      ptr      = pool.allocate();
+
+    stats.nPooledBytes += (pool.capacity() - capacity) * pool.slotSize();
+    return ptr;
+  }
+
+  void deallocate(void* ptr, size_t size)
+  {
+    int index = poolIndex(size);
+
+    if (index < 0) {
+      ::free(ptr);
+    }
+    else {
+      pools[index].deallocate(ptr);
+    }
+  }
+
+  static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+  {
+    Allocator* allocator = static_cast<Allocator*>(ud);
+    size_t     oldSize   = ptr == nullptr ? 0 : osize;
+
+    allocator->stats.nUsedBytes += int64(nsize) - int64(oldSize);
+
+    if (nsize > oldSize) {
+      allocator->stats.nAllocs += 1;
+      allocator->stats.nBytes  += int64(nsize - oldSize);
+    }
+
+    if (nsize == 0) {
+      if (ptr != nullptr) {
+        allocator->deallocate(ptr, oldSize);
+      }
+      return nullptr;
+    }
+
+    int oldIndex = ptr == nullptr ? -2 : poolIndex(oldSize);
+    int newIndex = poolIndex(nsize);
+
+    if (oldIndex == newIndex) {
+      return newIndex < 0 ? realloc(ptr, nsize) : ptr;
+    }
+
+    void* newPtr = allocator->allocate(nsize);
+
+    if (newPtr != nullptr && ptr != nullptr) {
+      memcpy(newPtr, ptr, min(oldSize, nsize));
+      allocator->deallocate(ptr, oldSize);
+    }
+    return newPtr;
+  }
+};
+
+namespace
+{
+
+int panic(lua_State* l)
+{
+  OZ_ERROR("oz::Lua: Unprotected error: %s", lua_tostring(l, -1));
+}
+
+}
+
+int      Lua::randomSeed  = 0;
+bool     Lua::isProfiling = false;
+Duration Lua::gcSlice;
 
 Lua::Lua(const char* libs)
 {
@@ -703,10 +805,11 @@ Lua::Result Lua::load(const File& file)
     }
   }
 
+  gcLiveKiB_ = lua_gc(l_, LUA_GCCOUNT, 0);
   return Result(l_);
 }
 
-void Lua::loadDir(const File& dir) const
+void Lua::loadDir(const File& dir)
 {
   for (const File& file : dir.list()) {
     if (!file.isRegular() || !file.hasExtension("lua")) {
@@ -724,6 +827,91 @@ void Lua::loadDir(const File& dir) const
       OZ_ERROR("oz::Lua: %s", lua_tostring(l_, -1));
     }
   }
+
+  gcLiveKiB_ = lua_gc(l_, LUA_GCCOUNT, 0);
+}
+
+void Lua::bindFunctions(const List<String>& names)
+{
+  for (int ref : functionRefs) {
+    luaL_unref(l_, LUA_REGISTRYINDEX, ref);
+  }
+  functionRefs.clear();
+
+  for (const String& name : names) {
+    lua_getglobal(l_, name);
+    functionRefs.add(luaL_ref(l_, LUA_REGISTRYINDEX));
+  }
+}
+
+void Lua::pushFunction(int index, const char* name) const
+{
+  if (uint(index) < uint(functionRefs.size())) {
+    lua_rawgeti(l_, LUA_REGISTRYINDEX, functionRefs[index]);
+  }
+  else {
+    lua_getglobal(l_, name);
+  }
+}
+
+int Lua::pcall(const char* name, int nArgs, int nResults)
+{
+  if (!isProfiled_) {
+    return lua_pcall(l_, nArgs, nResults, 0);
+  }
+
+  int64           nBytes       = allocator_->stats.nBytes;
+  Instant<STEADY> beginInstant = Instant<STEADY>::now();
+
+  int result = lua_pcall(l_, nArgs, nResults, 0);
+
+  // Looked up after the call, nested calls may add entries.
+  CallStats* stats = callStats.find(name);
+
+  if (stats == nullptr) {
+    stats = &callStats.add(name, CallStats()).value;
+  }
+
+  stats->time   += Instant<STEADY>::now() - beginInstant;
+  stats->nCalls += 1;
+  stats->nBytes += allocator_->stats.nBytes - nBytes;
+  return result;
+}
+
+void Lua::flushCallStats(const char* prefix)
+{
+  for (const auto& i : callStats) {
+    Profiler::add(prefix + i.key, i.value.time, i.value.nCalls, i.value.nBytes);
+  }
+  callStats.clear();
+}
+
+Lua::AllocStats Lua::allocStats() const
+{
+  return allocator_ == nullptr ? AllocStats() : allocator_->stats;
+}
+
+void Lua::stepGarbage()
+{
+  if (gcSlice_ == Duration::ZERO) {
+    return;
+  }
+
+  Instant<STEADY> endInstant = Instant<STEADY>::now() + gcSlice_;
+  bool            isOverdue  = lua_gc(l_, LUA_GCCOUNT, 0) >= 2 * gcLiveKiB_;
+
+  do {
+    if (lua_gc(l_, LUA_GCSTEP, 0) != 0) {
+      gcLiveKiB_ = lua_gc(l_, LUA_GCCOUNT, 0);
+      break;
+    }
+  }
+  while (isOverdue || Instant<STEADY>::now() < endInstant);
+
+#if LUA_VERSION_NUM < 502
+  // Stepping re-enables automatic GC.
+  lua_gc(l_, LUA_GCSTOP, 0);
+#endif
 }
 
 void Lua::init(const char* libs)
@@ -732,11 +920,19 @@ void Lua::init(const char* libs)
 
   libs = String::index(libs, 'A') >= 0 ? "ctiosmdp" : libs;
 
+  allocator_ = new Allocator();
+
+#ifdef LUA_JITLIBNAME
   l_ = luaL_newstate();
+#else
+  l_ = lua_newstate(Allocator::alloc, allocator_);
+#endif
   if (l_ == nullptr) {
     OZ_ERROR("oz::Lua: Failed to create Lua state");
   }
 
+  lua_atpanic(l_, panic);
+
   luaL_requiref(l_, "", luaopen_base, true);
 
   if (String::index(libs, 'c') >= 0) {
@@ -768,6 +964,14 @@ void Lua::init(const char* libs)
   }
 
   lua_settop(l_, 0);
+
+  isProfiled_ = isProfiling;
+  gcSlice_    = gcSlice;
+  gcLiveKiB_  = lua_gc(l_, LUA_GCCOUNT, 0);
+
+  if (gcSlice_ != Duration::ZERO) {
+    lua_gc(l_, LUA_GCSTOP, 0);
+  }
 }
 
 void Lua::destroy()
@@ -778,6 +982,17 @@ void Lua::destroy()
     lua_close(l_);
     l_ = nullptr;
   }
+
+  delete allocator_;
+  allocator_  = nullptr;
+  gcSlice_    = Duration::ZERO;
+  isProfiled_ = false;
+
+  callStats.clear();
+  callStats.trim();
+
+  functionRefs.clear();
+  functionRefs.trim();
 }
 
 }
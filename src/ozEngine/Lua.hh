@@ -489,13 +489,54 @@ public:
 
   };
 
+  /**
+   * Call statistics of a function, collected when profiling.
+   */
+  struct CallStats
+  {
+    Duration time   = Duration::ZERO; ///< Inclusive time.
+    int64    nCalls = 0;              ///< Number of calls.
+    int64    nBytes = 0;              ///< Bytes allocated during calls.
+  };
+
+  /**
+   * Memory statistics of a state.
+   *
+   * Blocks up to `MAX_POOLED_SIZE` bytes are allocated from pools of size classes, the rest from
+   * the heap. Statistics are all zero with LuaJIT, which doesn't support custom allocators.
+   */
+  struct AllocStats
+  {
+    int64 nAllocs      = 0; ///< Number of allocations and growing reallocations so far.
+    int64 nBytes       = 0; ///< Bytes allocated so far, growth of reallocated blocks included.
+    int64 nUsedBytes   = 0; ///< Bytes in use.
+    int64 nPooledBytes = 0; ///< Capacity of all pools.
+  };
+
+  /// Largest block allocated from pools.
+  static constexpr int MAX_POOLED_SIZE = 256;
+
+private:
+
+  struct Allocator;
+
+  Allocator* allocator_  = nullptr; ///< Size-class pools and statistics.
+  Duration   gcSlice_;              ///< GC time per `stepGarbage()`, zero for automatic GC.
+  int64      gcLiveKiB_  = 0;       ///< Memory in use after the last GC cycle or script load.
+  bool       isProfiled_ = false;   ///< Collect call statistics.
+
 public:
 
-  lua_State* l_ = nullptr; ///< %Lua state escriptor.
+  lua_State*                 l_ = nullptr; ///< %Lua state escriptor.
+  List<int>                  functionRefs; ///< Registry references to functions bound by
+                                           ///< `bindFunctions()`.
+  HashMap<String, CallStats> callStats;    ///< Statistics of calls through `pcall()`.
 
 public:
 
-  static int randomSeed; ///< Random seed for Lua environments.
+  static int      randomSeed;  ///< Random seed for Lua environments.
+  static bool     isProfiling; ///< Collect call statistics in states created afterwards.
+  static Duration gcSlice;     ///< GC slice for states created afterwards, zero for automatic GC.
 
 public:
 
@@ -551,13 +592,58 @@ public:
 
   /**
    * Load and execute a script.
+   *
+   * Memory in use afterwards is taken as live for scheduling `stepGarbage()`.
    */
   Result load(const File& file);
 
   /**
-   * Load and execute all `*.lua` files in a directory.
+   * Load and execute all `*.lua` files in a directory, the same as `load()` on each.
+   */
+  void loadDir(const File& dir);
+
+  /**
+   * Reference global functions with given names, so they can be pushed by index.
+   *
+   * References are to function values, later redefinitions of the globals are not seen. Undefined
+   * globals are referenced as nil.
+   */
+  void bindFunctions(const List<String>& names);
+
+  /**
+   * Push a function bound by `bindFunctions()` or, if the index is not valid, a global by name.
+   *
+   * Pushing a bound function is a single array access instead of hashing the name and looking it
+   * up in the globals table.
+   */
+  void pushFunction(int index, const char* name) const;
+
+  /**
+   * Call function on the stack like `lua_pcall()` and update its statistics when profiling.
+   *
+   * Time is inclusive and allocated bytes are only counted with the official %Lua, not LuaJIT.
+   */
+  int pcall(const char* name, int nArgs, int nResults);
+
+  /**
+   * Add call statistics to `Profiler` with keys prefixed by a given string and clear them.
+   */
+  void flushCallStats(const char* prefix);
+
+  /**
+   * Memory statistics.
+   */
+  AllocStats allocStats() const;
+
+  /**
+   * Run incremental GC for at most the state's GC slice.
+   *
+   * States created with a non-zero `gcSlice` don't collect garbage on their own and rely on this
+   * being called once per tick. A cycle is finished regardless of the slice if memory in use has
+   * grown to twice the amount left after the previous cycle, so garbage produced faster than it
+   * is collected cannot grow without bounds.
    */
-  void loadDir(const File& dir) const;
+  void stepGarbage();
 
   /**
    * (Re)create a new %Lua state loading only given libraries.
@@ -0,0 +1,74 @@
+/*
+ * OpenZone - simple cross-platform FPS/RTS game engine.
+ *
+ * Copyright © 2002-2019 Davorin Učakar
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <ozEngine/ozEngine.hh>
+
+#include <lua.hpp>
+
+using namespace oz;
+
+namespace
+{
+
+constexpr int CALLS = 2000000;
+
+const char* const SCRIPT =
+  "function onUse(self) return true end\n"
+  "function onUpdate(self) return true end\n"
+  "function onDestroy(self) return true end\n"
+  "function onShot(self) return true end\n"
+  "function prey(self) end\n";
+
+}
+
+int main()
+{
+  System::init();
+
+  Lua lua("");
+  lua(SCRIPT);
+
+  List<String> names = {"onUse", "onUpdate", "onDestroy", "onShot", "prey"};
+  lua.bindFunctions(names);
+
+  lua_State* l = lua.l_;
+
+  Instant t0 = Instant<STEADY>::now();
+
+  for (int i = 0; i < CALLS; ++i) {
+    lua_getglobal(l, names[i % names.size()]);
+    lua_pushinteger(l, i);
+    lua_call(l, 1, 0);
+  }
+
+  Instant t1 = Instant<STEADY>::now();
+
+  for (int i = 0; i < CALLS; ++i) {
+    lua.pushFunction(i % names.size(), names[i % names.size()]);
+    lua_pushinteger(l, i);
+    lua_call(l, 1, 0);
+  }
+
+  Instant t2 = Instant<STEADY>::now();
+
+  Log() << "by name:      " << (t1 - t0).ms() << " ms";
+  Log() << "by reference: " << (t2 - t1).ms() << " ms";
+  return 0;
+}
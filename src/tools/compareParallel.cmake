@@ -0,0 +1,21 @@
+# Run ozServer on the same world with serial and parallel physics and compare per-tick hash logs.
+#
+# Variables: SERVER (ozServer executable), LAYOUT (world layout) and PREFIX (data prefix).
+
+foreach(threads 1 4)
+  execute_process(
+    COMMAND ${SERVER} -e ${LAYOUT} -p ${PREFIX} -r 0 -t 20 -j ${threads} -d hashes-j${threads}.log
+    RESULT_VARIABLE result)
+
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "ozServer -j ${threads} failed: ${result}")
+  endif()
+endforeach()
+
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E compare_files hashes-j1.log hashes-j4.log
+  RESULT_VARIABLE result)
+
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "Serial and parallel physics diverged, diff hashes-j1.log and hashes-j4.log")
+endif()
@@ -0,0 +1,473 @@
+/*
+ * OpenZone - simple cross-platform FPS/RTS game engine.
+ *
+ * Copyright © 2002-2019 Davorin Učakar
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <client/config.hh>
+#include <matrix/Liber.hh>
+#include <matrix/Synapse.hh>
+#include <matrix/Matrix.hh>
+#include <matrix/Replay.hh>
+#include <nirvana/Nirvana.hh>
+
+#include <cstdlib>
+#include <getopt.h>
+
+using namespace oz;
+
+namespace
+{
+
+File     stateFile;
+File     layoutFile;
+File     replayFile;
+File     hashLogFile;
+File     prefixDir        = OZ_PREFIX;
+int      nThreads         = 1;
+int      nMindThreads     = 1;
+Duration mindBudget       = Duration::ZERO;
+int      tickRate         = int(Timer::TICKS_PER_SEC);
+Duration runDuration      = 60_s;
+
+Duration matrixDuration   = Duration::ZERO;
+Duration nirvanaDuration  = Duration::ZERO;
+Duration sleepDuration    = Duration::ZERO;
+Duration maxTickDuration  = Duration::ZERO;
+
+int      nHashes          = 0;
+int      nMismatches      = 0;
+uint64   firstMismatch    = 0;
+
+Stream              hashLog(0);
+List<Orbis::Digest> hashChanges;
+
+void printUsage()
+{
+  Log::printRaw(
+    "Usage: ozServer [-v] (-i <state> | -e <layout> | -R <replay>) [-r <rate>] [-t <num>]\n"
+    "                [-j <num>] [-m <num>] [-b <ms>] [-d <file>] [-p <prefix>]\n"
+    "  -i <state>   Load saved game state <state> (e.g. an autosave written by the client).\n"
+    "  -e <layout>  Load world layout <layout> as written by the editor.\n"
+    "  -R <replay>  Re-simulate session recorded by the client as fast as possible and verify\n"
+    "               world hashes. Options -r and -t are ignored.\n"
+    "  -r <rate>    Run <rate> ticks per second of real time, 0 runs as fast as possible.\n"
+    "               Each tick is still %.2f ms of game time. Defaults to %d.\n"
+    "  -t <num>     Exit after <num> seconds of game time (can be a floating-point number),\n"
+    "               0 runs forever. Defaults to 60.\n"
+    "  -j <num>     Run physics on <num> threads. Defaults to 1.\n"
+    "  -m <num>     Run minds on <num> threads, each with its own Lua state. Defaults to 1.\n"
+    "  -b <ms>      Update at most as many minds per tick as fit into <ms> milliseconds, the\n"
+    "               rest are postponed. 0 updates all due minds. Defaults to 0, as runs with\n"
+    "               a budget are not reproducible.\n"
+    "  -d <file>    Write world hash after each tick to <file>, followed by digests of\n"
+    "               structures and objects that have changed. Logs of two runs can be diffed\n"
+    "               to find the first tick and object that diverged.\n"
+    "  -p <prefix>  Set global data directory to '<prefix>/share/openzone'.\n"
+    "               Defaults to '%s'.\n"
+    "  -v           Print verbose log messages to terminal.\n\n",
+    Timer::TICK_TIME * 1000.0f, int(Timer::TICKS_PER_SEC), OZ_PREFIX);
+}
+
+void mountData()
+{
+  File globalDataDir = prefixDir / "share/openzone";
+  File userDataDir   = File::DATA / "openzone";
+
+  Log::println("Content search path {");
+  Log::indent();
+
+  for (const File& dir : {userDataDir, globalDataDir}) {
+    if (dir.mountAt(nullptr, true)) {
+      Log::println("%s", dir.c());
+
+      for (const File& file : dir.list("zip")) {
+        if (!file.mountAt(nullptr)) {
+          OZ_ERROR("Failed to mount '%s' on / in PhysicsFS", file.c());
+        }
+        Log::println("%s", file.c());
+      }
+    }
+  }
+
+  Log::unindent();
+  Log::println("}");
+}
+
+void readWorld()
+{
+  if (!replayFile.isEmpty()) {
+    Log::print("Loading replay from '%s' ...", replayFile.c());
+
+    Stream is(0);
+    if (!replay.beginReplay(replayFile, &is)) {
+      OZ_ERROR("Reading replay '%s' failed", replayFile.c());
+    }
+
+    Log::printEnd(" OK");
+
+    matrix.read(&is);
+    nirvana.read(&is);
+  }
+  else if (!stateFile.isEmpty()) {
+    Log::print("Loading state from '%s' ...", stateFile.c());
+
+    Stream is(0);
+    if (!Matrix::readState(stateFile, &is)) {
+      OZ_ERROR("Reading saved state '%s' failed", stateFile.c());
+    }
+
+    Log::printEnd(" OK");
+
+    // Client state (camera, mission script) follows and is ignored.
+    matrix.read(&is);
+    nirvana.read(&is);
+  }
+  else {
+    Log::print("Loading layout from '%s' ...", layoutFile.c());
+
+    Json json;
+    if (!json.load(layoutFile)) {
+      OZ_ERROR("Reading saved layout '%s' failed", layoutFile.c());
+    }
+
+    Log::printEnd(" OK");
+
+    matrix.read(json["matrix"]);
+  }
+
+  nirvana.sync();
+  synapse.update();
+}
+
+uint64 hashWorld()
+{
+  if (hashLogFile.isEmpty()) {
+    return matrix.hash();
+  }
+
+  hashChanges.clear();
+
+  uint64 value = matrix.hash(&hashChanges);
+
+  hashLog.writeLine(String::format("tick %lu %016lx", ulong(timer.nTicks), ulong(value)));
+
+  for (const Orbis::Digest& digest : hashChanges) {
+    if (digest.index < 0) {
+      hashLog.writeLine(String::format("  str %5d %016lx", ~digest.index, ulong(digest.value)));
+    }
+    else {
+      hashLog.writeLine(String::format("  obj %5d %016lx", digest.index, ulong(digest.value)));
+    }
+  }
+  return value;
+}
+
+void run()
+{
+  Duration        tickDuration = tickRate == 0 ? Duration::ZERO : 1_s / int64(tickRate);
+  Instant<STEADY> nextInstant  = Instant<STEADY>::now();
+
+  while (runDuration == Duration::ZERO || timer.duration < runDuration) {
+    Instant<STEADY> beginInstant = Instant<STEADY>::now();
+
+    timer.tick();
+
+    matrix.update();
+
+    Instant<STEADY> matrixInstant = Instant<STEADY>::now();
+
+    nirvana.sync();
+    synapse.update();
+    nirvana.update();
+
+    Instant<STEADY> endInstant = Instant<STEADY>::now();
+
+    matrixDuration  += matrixInstant - beginInstant;
+    nirvanaDuration += endInstant - matrixInstant;
+    maxTickDuration  = max(maxTickDuration, endInstant - beginInstant);
+
+    if (!hashLogFile.isEmpty()) {
+      hashWorld();
+    }
+
+    if (tickDuration != Duration::ZERO) {
+      nextInstant += tickDuration;
+
+      if (endInstant < nextInstant) {
+        sleepDuration += nextInstant - endInstant;
+        Thread::sleepUntil(nextInstant);
+      }
+      else if (endInstant - nextInstant > Timer::MAX_CATCHUP_TICKS * tickDuration) {
+        // Too far behind, drop time instead of running the following ticks back to back.
+        timer.drop(endInstant - nextInstant);
+        nextInstant = endInstant;
+      }
+    }
+  }
+}
+
+void setPlayer(int oldBot, int newBot)
+{
+  Mind* oldMind = nirvana.minds.find(oldBot);
+  Mind* newMind = nirvana.minds.find(newBot);
+
+  if (oldMind != nullptr) {
+    oldMind->flags &= ~Mind::PLAYER_BIT;
+  }
+  if (newMind != nullptr) {
+    newMind->flags |= Mind::PLAYER_BIT;
+  }
+}
+
+void runReplay()
+{
+  int player = -1;
+
+  while (replay.readTick()) {
+    Instant<STEADY> beginInstant = Instant<STEADY>::now();
+
+    timer.tick();
+
+    if (replay.input.bot != player) {
+      setPlayer(player, replay.input.bot);
+      player = replay.input.bot;
+    }
+    replay.applyInput();
+
+    matrix.random.seed(replay.matrixSeed);
+    matrix.update();
+
+    Instant<STEADY> matrixInstant = Instant<STEADY>::now();
+
+    nirvana.sync();
+    synapse.update();
+
+    matrix.random.seed(replay.nirvanaSeed);
+    nirvana.updateLimit = replay.nMindUpdates;
+    nirvana.update();
+
+    Instant<STEADY> endInstant = Instant<STEADY>::now();
+
+    matrixDuration  += matrixInstant - beginInstant;
+    nirvanaDuration += endInstant - matrixInstant;
+    maxTickDuration  = max(maxTickDuration, endInstant - beginInstant);
+
+    bool   isChecked = replay.flags & Replay::HASH_BIT;
+    uint64 value     = isChecked || !hashLogFile.isEmpty() ? hashWorld() : 0;
+
+    if (isChecked) {
+      ++nHashes;
+
+      if (value != replay.hash) {
+        if (nMismatches == 0) {
+          firstMismatch = timer.nTicks;
+          Log::println("World diverged from the recording at tick %lu", ulong(firstMismatch));
+        }
+        ++nMismatches;
+      }
+    }
+  }
+}
+
+void printTimings(Duration runTime)
+{
+  float runSecs  = runTime.t();
+  float nTicks   = float(timer.nTicks);
+  float gameSecs = timer.duration.t();
+
+  Log::println("Time statistics {");
+  Log::indent();
+  Log::println("run time              %8.2f s",     runSecs);
+  Log::println("game time             %8.2f s",     gameSecs);
+  Log::println("ticks                 %8lu",        ulong(timer.nTicks));
+  Log::println("tick rate in run time   %6.2f Hz",  nTicks / runSecs);
+  Log::println("game/run time ratio     %6.2f",     gameSecs / runSecs);
+  Log::println("longest tick            %6.2f ms",  maxTickDuration.t() * 1000.0f);
+  Log::println("Run time usage {");
+  Log::indent();
+  Log::println("%6.2f %%  %6.3f ms/tick  matrix",
+               matrixDuration.t() / runSecs * 100.0f, matrixDuration.t() / nTicks * 1000.0f);
+  Log::println("%6.2f %%  %6.3f ms/tick  nirvana",
+               nirvanaDuration.t() / runSecs * 100.0f, nirvanaDuration.t() / nTicks * 1000.0f);
+  Log::println("%6.2f %%  %6.3f ms/tick  sleep",
+               sleepDuration.t() / runSecs * 100.0f, sleepDuration.t() / nTicks * 1000.0f);
+  Log::unindent();
+  Log::println("}");
+  if (!replayFile.isEmpty()) {
+    Log::println("world hashes checked  %8d",       nHashes);
+    Log::println("world hash mismatches %8d",       nMismatches);
+  }
+  Log::unindent();
+  Log::println("}");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  System::init();
+
+  Log::printRaw("OpenZone Server " OZ_VERSION "\n"
+                "Copyright © 2002-2019 Davorin Učakar\n"
+                "This program comes with ABSOLUTELY NO WARRANTY.\n"
+                "This is free software, and you are welcome to redistribute it\n"
+                "under certain conditions; See COPYING file for details.\n\n");
+
+  // Standalone. Executable is ./bin/<platform>/ozServer.
+  if (prefixDir.isEmpty()) {
+    prefixDir = File::EXECUTABLE.directory() / "../..";
+  }
+
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "i:e:R:r:t:j:m:b:d:p:vhH?")) >= 0) {
+    const char* end = nullptr;
+
+    switch (opt) {
+      case 'i': {
+        stateFile = optarg;
+        break;
+      }
+      case 'e': {
+        layoutFile = optarg;
+        break;
+      }
+      case 'R': {
+        replayFile = optarg;
+        break;
+      }
+      case 'r': {
+        tickRate = String::parseInt(optarg, &end);
+
+        if (end == optarg || tickRate < 0) {
+          printUsage();
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case 't': {
+        runDuration = String::parseDouble(optarg, &end) * 1_s;
+
+        if (end == optarg || runDuration < Duration::ZERO) {
+          printUsage();
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case 'j': {
+        nThreads = String::parseInt(optarg, &end);
+
+        if (end == optarg || nThreads < 1) {
+          printUsage();
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case 'm': {
+        nMindThreads = String::parseInt(optarg, &end);
+
+        if (end == optarg || nMindThreads < 1) {
+          printUsage();
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case 'b': {
+        mindBudget = String::parseDouble(optarg, &end) * 1_ms;
+
+        if (end == optarg || mindBudget < Duration::ZERO) {
+          printUsage();
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case 'd': {
+        hashLogFile = optarg;
+        break;
+      }
+      case 'p': {
+        prefixDir = optarg;
+        break;
+      }
+      case 'v': {
+        Log::showVerbose = true;
+        break;
+      }
+      default: {
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  int nSources = !stateFile.isEmpty() + !layoutFile.isEmpty() + !replayFile.isEmpty();
+
+  if (optind != argc || nSources != 1) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  File::init(argv[0]);
+  mountData();
+
+  // Fixed seed, so runs of the same world are comparable.
+  Math::seed(42);
+  matrix.random.seed(42);
+  Lua::randomSeed = 42;
+
+  liber.init("");
+  matrix.init(nThreads);
+  nirvana.init(nMindThreads, mindBudget);
+
+  timer.reset();
+
+  matrix.load();
+  nirvana.load();
+
+  readWorld();
+
+  Log::println("Running simulation {");
+  Log::indent();
+
+  Instant<STEADY> beginInstant = Instant<STEADY>::now();
+
+  if (replayFile.isEmpty()) {
+    run();
+  }
+  else {
+    runReplay();
+  }
+
+  Duration runTime = Instant<STEADY>::now() - beginInstant;
+
+  Log::unindent();
+  Log::println("}");
+
+  printTimings(runTime);
+
+  if (!hashLogFile.isEmpty() && !hashLogFile.write(hashLog)) {
+    OZ_ERROR("Failed to write hash log '%s'", hashLogFile.c());
+  }
+
+  nirvana.unload();
+  matrix.unload();
+
+  nirvana.destroy();
+  matrix.destroy();
+  liber.destroy();
+
+  return nMismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
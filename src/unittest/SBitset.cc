@@ -0,0 +1,52 @@
+/*
+ * liboz - OpenZone Core Library.
+ *
+ * Copyright © 2002-2019 Davorin Učakar
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgement in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "unittest.hh"
+
+using namespace oz;
+
+void test_SBitset()
+{
+  Log() << "+ SBitset";
+
+  SBitset<130> bitset;
+
+  OZ_CHECK(bitset.findFirstZero() == 0)
+  OZ_CHECK(bitset.findFirstZero(129) == 129)
+  OZ_CHECK(bitset.findFirstZero(130) == -1)
+
+  for (int i = 0; i < 130; ++i) {
+    bitset.set(i);
+  }
+
+  OZ_CHECK(bitset.findFirstZero() == -1)
+
+  bitset.clear(3);
+  bitset.clear(64);
+  bitset.clear(127);
+
+  OZ_CHECK(bitset.findFirstZero() == 3)
+  OZ_CHECK(bitset.findFirstZero(3) == 3)
+  OZ_CHECK(bitset.findFirstZero(4) == 64)
+  OZ_CHECK(bitset.findFirstZero(65) == 127)
+  OZ_CHECK(bitset.findFirstZero(128) == -1)
+}
@@ -47,6 +47,7 @@ int main()
   test_common();
   test_iterables();
   test_Arrays();
+  test_SBitset();
 
   Log() << (hasPassed ? "Unittest PASSED" : "Unittest FAILED");
   return EXIT_SUCCESS;
@@ -159,6 +159,7 @@ struct Foo : oz::DChainNode<Foo>
 void test_common();
 void test_iterables();
 void test_Arrays();
+void test_SBitset();
 
 void test_Alloc();
 